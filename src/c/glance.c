@@ -0,0 +1,64 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "glance.h"
+#include "trip_format.h"
+
+#ifndef PBL_PLATFORM_APLITE
+
+#define GLANCE_SUBTITLE_LENGTH 64
+
+typedef struct {
+  const SelectedJourney *journey;
+  const TripData *trips;
+  time_t now;
+} GlanceContext;
+
+static void prv_reload(AppGlanceReloadSession *session, size_t limit, void *context) {
+  const GlanceContext *glance = context;
+  const TripData *trips = glance->trips;
+  char clock[6];
+  char subtitle[GLANCE_SUBTITLE_LENGTH];
+  size_t added = 0;
+
+  for (int i = 0; i < trips->count && added < limit; i++) {
+    if (trips->departures[i] <= glance->now || (trips->flags[i] & TRIP_FLAG_CANCELLED)) { continue; }
+
+    trip_format_clock_time(trips->departures[i], clock, sizeof(clock));
+    if (trips->platform[i][0] != '\0') {
+      snprintf(subtitle, sizeof(subtitle), "%s to %s, platform %s", clock, glance->journey->dest_station_name, trips->platform[i]);
+    } else {
+      snprintf(subtitle, sizeof(subtitle), "%s to %s", clock, glance->journey->dest_station_name);
+    }
+
+    const AppGlanceSlice slice = {
+      .layout = {
+        .icon = APP_GLANCE_SLICE_DEFAULT_ICON,
+        .subtitle_template_string = subtitle,
+      },
+      .expiration_time = trips->departures[i],
+    };
+    if (app_glance_add_slice(session, slice) != APP_GLANCE_RESULT_SUCCESS) { break; }
+    added++;
+  }
+}
+
+void glance_publish(const SelectedJourney *journey, const TripData *trips, time_t now) {
+  GlanceContext context = { .journey = journey, .trips = trips, .now = now };
+  app_glance_reload(prv_reload, &context);
+}
+
+#endif
@@ -0,0 +1,32 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <pebble.h>
+#include "trein_data.h"
+
+// App Glance for the launcher: one slice per upcoming trip of the last viewed
+// route, each expiring when its train departs, so the launcher moves on to the
+// next train without the app running. Aplite has no App Glance, so there this
+// compiles to nothing.
+
+#ifndef PBL_PLATFORM_APLITE
+// Replace the app's glance with the trips that have not departed at `now`.
+// Clears the glance when there are none.
+void glance_publish(const SelectedJourney *journey, const TripData *trips, time_t now);
+#else
+#define glance_publish(journey, trips, now)
+#endif
@@ -0,0 +1,139 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "heap_debug.h"
+
+#ifdef TREIN_DEBUG
+#include "trein_data.h"
+
+// Heap a window may allocate while loading, and the peak the whole app may
+// reach. Aplite leaves roughly 24 KB for the app, the other platforms more.
+#ifdef PBL_PLATFORM_APLITE
+#define HEAP_PEAK_BUDGET 12288
+static const uint16_t s_window_budgets[HEAP_SCOPE_COUNT] = {
+  [HEAP_SCOPE_MAIN] = 512,
+  [HEAP_SCOPE_MENU] = 1024,
+  [HEAP_SCOPE_DEST_MENU] = 1024,
+  [HEAP_SCOPE_ALPHA_MENU] = 1024,
+  [HEAP_SCOPE_SEARCH] = 768,
+  [HEAP_SCOPE_SEARCH_RESULTS] = 1024,
+  [HEAP_SCOPE_COUNTDOWN] = 3072,
+  [HEAP_SCOPE_REMINDER] = 512,
+};
+#else
+#define HEAP_PEAK_BUDGET 32768
+static const uint16_t s_window_budgets[HEAP_SCOPE_COUNT] = {
+  [HEAP_SCOPE_MAIN] = 1024,
+  [HEAP_SCOPE_MENU] = 2048,
+  [HEAP_SCOPE_DEST_MENU] = 2048,
+  [HEAP_SCOPE_ALPHA_MENU] = 2048,
+  [HEAP_SCOPE_SEARCH] = 1536,
+  [HEAP_SCOPE_SEARCH_RESULTS] = 2048,
+  [HEAP_SCOPE_COUNTDOWN] = 6144,
+  [HEAP_SCOPE_REMINDER] = 1024,
+};
+#endif
+
+static const char *const s_scope_names[HEAP_SCOPE_COUNT] = {
+  "main", "menu", "dest_menu", "alpha_menu", "search", "search_results", "countdown", "reminder", "messages",
+};
+
+typedef struct {
+  size_t load_baseline;  // heap_bytes_used() when the load started
+  size_t cost;           // Heap allocated by the last load
+  size_t max_cost;
+  size_t max_sampled_used;  // Highest heap_bytes_used() sampled in this scope
+  size_t max_stack;
+  uint16_t samples;
+} HeapScopeStats;
+
+static HeapScopeStats s_stats[HEAP_SCOPE_COUNT];
+static uintptr_t s_stack_base;
+static size_t s_peak_used;
+
+static void prv_fail(const char *what, HeapScope scope, size_t value, size_t budget) {
+  APP_LOG(APP_LOG_LEVEL_ERROR, "Heap budget exceeded: %s %s %d > %d",
+          s_scope_names[scope], what, (int)value, (int)budget);
+  heap_debug_report();
+  __builtin_trap();
+}
+
+// Record the current heap and stack use against a scope
+static void prv_sample(HeapScope scope) {
+  volatile uint8_t marker;
+  const size_t used = heap_bytes_used();
+  const size_t stack = s_stack_base - (uintptr_t)&marker;
+  HeapScopeStats *stats = &s_stats[scope];
+  stats->samples++;
+  if (used > stats->max_sampled_used) { stats->max_sampled_used = used; }
+  if (stack > stats->max_stack) { stats->max_stack = stack; }
+  if (used > s_peak_used) { s_peak_used = used; }
+  if (s_peak_used > HEAP_PEAK_BUDGET) { prv_fail("peak", scope, s_peak_used, HEAP_PEAK_BUDGET); }
+}
+
+void heap_debug_init(void) {
+  volatile uint8_t marker;
+  s_stack_base = (uintptr_t)&marker;
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "AppData %d B, heap used %d B, free %d B",
+          (int)sizeof(AppData), (int)heap_bytes_used(), (int)heap_bytes_free());
+}
+
+void heap_debug_window_loading(HeapScope scope) {
+  s_stats[scope].load_baseline = heap_bytes_used();
+}
+
+void heap_debug_window_loaded(HeapScope scope) {
+  HeapScopeStats *stats = &s_stats[scope];
+  const size_t used = heap_bytes_used();
+  stats->cost = (used > stats->load_baseline) ? used - stats->load_baseline : 0;
+  if (stats->cost > stats->max_cost) { stats->max_cost = stats->cost; }
+  prv_sample(scope);
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Loaded %s: +%d B, used %d B, free %d B",
+          s_scope_names[scope], (int)stats->cost, (int)used, (int)heap_bytes_free());
+  if (stats->cost > s_window_budgets[scope]) {
+    prv_fail("load", scope, stats->cost, s_window_budgets[scope]);
+  }
+}
+
+void heap_debug_window_unloaded(HeapScope scope) {
+  prv_sample(scope);
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Unloaded %s: used %d B, free %d B",
+          s_scope_names[scope], (int)heap_bytes_used(), (int)heap_bytes_free());
+}
+
+void heap_debug_sample(HeapScope scope) {
+  prv_sample(scope);
+}
+
+void heap_debug_message_decoded(uint32_t key, uint16_t length) {
+  prv_sample(HEAP_SCOPE_MESSAGES);
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Decoded %d (%d B): used %d B, free %d B",
+          (int)key, (int)length, (int)heap_bytes_used(), (int)heap_bytes_free());
+}
+
+void heap_debug_report(void) {
+  APP_LOG(APP_LOG_LEVEL_INFO, "Heap report: peak %d B of %d B budget, free now %d B",
+          (int)s_peak_used, HEAP_PEAK_BUDGET, (int)heap_bytes_free());
+  for (int i = 0; i < HEAP_SCOPE_COUNT; i++) {
+    const HeapScopeStats *stats = &s_stats[i];
+    if (stats->samples == 0) { continue; }
+    APP_LOG(APP_LOG_LEVEL_INFO, "  %s: load %d/%d B, highest sampled %d B, stack %d B, %d samples",
+            s_scope_names[i], (int)stats->max_cost, (int)s_window_budgets[i],
+            (int)stats->max_sampled_used, (int)stats->max_stack, stats->samples);
+  }
+}
+#endif
@@ -0,0 +1,60 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <pebble.h>
+
+// Heap and stack instrumentation, compiled in only when building with
+// TREIN_DEBUG=1 in the environment (see wscript). Every window load and unload
+// and every decoded message records heap_bytes_used() and the stack depth, as
+// do the allocation-heavy paths that call heap_debug_sample() while a window
+// is open. The SDK has no allocation hook, so the peaks are the highest
+// samples rather than true high-water marks.
+// Each window's heap cost (growth during its load) is checked against a
+// per-platform budget; exceeding it logs an error and traps, so the debug
+// build stops at the window that broke its budget.
+
+typedef enum {
+  HEAP_SCOPE_MAIN,
+  HEAP_SCOPE_MENU,
+  HEAP_SCOPE_DEST_MENU,
+  HEAP_SCOPE_ALPHA_MENU,
+  HEAP_SCOPE_SEARCH,
+  HEAP_SCOPE_SEARCH_RESULTS,
+  HEAP_SCOPE_COUNTDOWN,
+  HEAP_SCOPE_REMINDER,
+  HEAP_SCOPE_MESSAGES,
+  HEAP_SCOPE_COUNT
+} HeapScope;
+
+#ifdef TREIN_DEBUG
+void heap_debug_init(void);
+void heap_debug_window_loading(HeapScope scope);
+void heap_debug_window_loaded(HeapScope scope);
+void heap_debug_window_unloaded(HeapScope scope);
+void heap_debug_sample(HeapScope scope);
+void heap_debug_message_decoded(uint32_t key, uint16_t length);
+void heap_debug_report(void);
+#else
+#define heap_debug_init()
+#define heap_debug_window_loading(scope)
+#define heap_debug_window_loaded(scope)
+#define heap_debug_window_unloaded(scope)
+#define heap_debug_sample(scope)
+#define heap_debug_message_decoded(key, length)
+#define heap_debug_report()
+#endif
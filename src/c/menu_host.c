@@ -0,0 +1,59 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "menu_host.h"
+
+static void prv_window_load(Window *window) {
+  const MenuHost *host = window_get_user_data(window);
+  heap_debug_window_loading(host->heap_scope);
+  Layer *window_layer = window_get_root_layer(window);
+  GRect bounds = layer_get_bounds(window_layer);
+  MenuLayer *menu_layer = menu_layer_create(bounds);
+  *host->menu_layer = menu_layer;
+  menu_layer_set_click_config_onto_window(menu_layer, window);
+  menu_layer_set_callbacks(menu_layer, NULL, host->callbacks);
+  #ifdef PBL_COLOR
+  menu_layer_set_normal_colors(menu_layer, GColorYellow, GColorBlack);
+  menu_layer_set_highlight_colors(menu_layer, GColorOxfordBlue, GColorWhite);
+  #endif
+  layer_add_child(window_layer, menu_layer_get_layer(menu_layer));
+  if (host->selected_row) {
+    menu_layer_set_selected_index(menu_layer, MenuIndex(0, *host->selected_row), MenuRowAlignCenter, false);
+  }
+
+  heap_debug_window_loaded(host->heap_scope);
+}
+
+static void prv_window_unload(Window *window) {
+  const MenuHost *host = window_get_user_data(window);
+  menu_layer_destroy(*host->menu_layer);
+  *host->menu_layer = NULL;
+  window_destroy(window);
+  *host->window = NULL;
+  heap_debug_window_unloaded(host->heap_scope);
+}
+
+void menu_host_push(const MenuHost *host) {
+  if (*host->window) { return; }
+  Window *window = window_create();
+  window_set_user_data(window, (void *)host);
+  window_set_window_handlers(window, (WindowHandlers) {
+    .load = prv_window_load, .unload = prv_window_unload,
+  });
+  *host->window = window;
+  window_stack_push(window, true);
+}
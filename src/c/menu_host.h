@@ -0,0 +1,37 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <pebble.h>
+#include "heap_debug.h"
+
+// A window holding one full-screen MenuLayer in the app's colours. All of the
+// app's menus differ only in their callbacks, so each is described by a static
+// MenuHost and pushed through menu_host_push(). The window and its MenuLayer
+// exist only while the menu is on the stack: both are created on push and
+// destroyed once the window is popped, and rebuilt from AppData on the next
+// push.
+typedef struct {
+  Window **window;              // Set while the menu is on the stack, NULL otherwise
+  MenuLayer **menu_layer;       // Likewise, for reloading the menu from outside
+  MenuLayerCallbacks callbacks;
+  const int *selected_row;      // Row to select on load, or NULL for the first row
+  HeapScope heap_scope;
+} MenuHost;
+
+// Create and push the menu described by host, unless it is already on the stack
+void menu_host_push(const MenuHost *host);
@@ -0,0 +1,152 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "protocol.h"
+#include "stations.h"
+
+static int32_t prv_read_int32(const uint8_t *data) {
+  return (int32_t)((uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24));
+}
+
+static int16_t prv_read_int16(const uint8_t *data) {
+  return (int16_t)((uint16_t)data[0] | ((uint16_t)data[1] << 8));
+}
+
+// Copy a length-prefixed string from a station list into the string pool.
+// Returns a pointer to the pooled string, or NULL if it does not fit.
+static const char *prv_pool_station_string(StationData *stations, const uint8_t *data, uint16_t length, uint16_t *offset, int *pool_used) {
+  if (*offset >= length) { return NULL; }
+  int string_length = data[*offset];
+  *offset += 1;
+  if (*offset + string_length > length || *pool_used + string_length + 1 > MAX_STATION_POOL_LENGTH) {
+    return NULL;
+  }
+  char *pooled = &stations->pool[*pool_used];
+  memcpy(pooled, &data[*offset], string_length);
+  pooled[string_length] = '\0';
+  *offset += string_length;
+  *pool_used += string_length + 1;
+  return pooled;
+}
+
+bool protocol_decode_station_list(const uint8_t *data, uint16_t length, StationData *stations) {
+  if (length < STATION_LIST_HEADER_SIZE || data[0] != STATION_LIST_VERSION) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Unsupported station payload");
+    return false;
+  }
+  int count = data[1];
+  if (count > MAX_STATIONS) { count = MAX_STATIONS; }
+
+  uint16_t offset = STATION_LIST_HEADER_SIZE;
+  int pool_used = 0;
+  int decoded = 0;
+  for (int i = 0; i < count && offset + 2 <= length; i++) {
+    uint16_t index = (uint16_t)(data[offset] | (data[offset + 1] << 8));
+    offset += 2;
+    if (index == STATION_INDEX_UNKNOWN) {
+      const char *code = prv_pool_station_string(stations, data, length, &offset, &pool_used);
+      const char *name = prv_pool_station_string(stations, data, length, &offset, &pool_used);
+      if (!code || !name) { break; }
+      stations->codes[decoded] = code;
+      stations->names[decoded] = name;
+    } else if (index < NUM_STATIONS) {
+      stations->codes[decoded] = station_code(&all_stations[index]);
+      stations->names[decoded] = station_name(&all_stations[index]);
+    } else {
+      continue;
+    }
+    decoded++;
+  }
+  stations->count = decoded;
+  return decoded > 0;
+}
+
+// Copy a NUL padded (not NUL terminated) platform field into a TripData slot
+static void prv_read_platform(const uint8_t *field, char *platform) {
+  int length = 0;
+  while (length < TRIP_RECORD_PLATFORM_LENGTH && length < MAX_PLATFORM_LENGTH - 1 && field[length] != '\0') {
+    platform[length] = field[length];
+    length++;
+  }
+  platform[length] = '\0';
+}
+
+bool protocol_decode_trip_data(const uint8_t *data, uint16_t length, TripData *trips) {
+  if (length < TRIP_RECORD_HEADER_SIZE || data[0] != TRIP_RECORD_VERSION) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Unsupported trip payload");
+    return false;
+  }
+  int count = data[1];
+  if (count > MAX_TRIPS) { count = MAX_TRIPS; }
+  if (length < TRIP_RECORD_HEADER_SIZE + count * TRIP_RECORD_SIZE) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Truncated trip payload: %d bytes", (int)length);
+    return false;
+  }
+
+  for (int i = 0; i < count; i++) {
+    const uint8_t *record = data + TRIP_RECORD_HEADER_SIZE + i * TRIP_RECORD_SIZE;
+    trips->departures[i] = prv_read_int32(record + TRIP_RECORD_OFFSET_DEPARTURE);
+    trips->planned_departures[i] = prv_read_int32(record + TRIP_RECORD_OFFSET_PLANNED_DEPARTURE);
+    trips->planned_arrivals[i] = prv_read_int32(record + TRIP_RECORD_OFFSET_PLANNED_ARRIVAL);
+    trips->arrivals[i] = prv_read_int32(record + TRIP_RECORD_OFFSET_ARRIVAL);
+    trips->delays[i] = prv_read_int16(record + TRIP_RECORD_OFFSET_DELAY);
+    trips->transfers[i] = record[TRIP_RECORD_OFFSET_TRANSFERS];
+    trips->flags[i] = record[TRIP_RECORD_OFFSET_FLAGS];
+
+    prv_read_platform(record + TRIP_RECORD_OFFSET_PLATFORM, trips->platform[i]);
+  }
+  trips->count = count;
+  return true;
+}
+
+uint8_t protocol_apply_trip_delta(const uint8_t *data, uint16_t length, TripData *trips, int *index) {
+  if (length < TRIP_DELTA_HEADER_SIZE || data[0] != TRIP_DELTA_VERSION) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Unsupported trip delta");
+    return 0;
+  }
+  *index = data[1];
+  uint8_t mask = data[2];
+  if (!trips->loaded || *index >= trips->count) { return 0; }
+
+  int expected = TRIP_DELTA_HEADER_SIZE;
+  if (mask & TRIP_DELTA_DELAY) { expected += 2; }
+  if (mask & TRIP_DELTA_PLATFORM) { expected += TRIP_RECORD_PLATFORM_LENGTH; }
+  if (mask & TRIP_DELTA_DEPARTURE) { expected += 4; }
+  if (mask & TRIP_DELTA_FLAGS) { expected += 1; }
+  if (length < expected) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Truncated trip delta: %d bytes", (int)length);
+    return 0;
+  }
+
+  const uint8_t *field = data + TRIP_DELTA_HEADER_SIZE;
+  if (mask & TRIP_DELTA_DELAY) {
+    trips->delays[*index] = prv_read_int16(field);
+    field += 2;
+  }
+  if (mask & TRIP_DELTA_PLATFORM) {
+    prv_read_platform(field, trips->platform[*index]);
+    field += TRIP_RECORD_PLATFORM_LENGTH;
+  }
+  if (mask & TRIP_DELTA_DEPARTURE) {
+    trips->departures[*index] = prv_read_int32(field);
+    field += 4;
+  }
+  if (mask & TRIP_DELTA_FLAGS) {
+    trips->flags[*index] = *field;
+  }
+  return mask;
+}
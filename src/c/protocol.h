@@ -0,0 +1,37 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <pebble.h>
+#include "trein_data.h"
+
+// Decoders for the byte-array payloads the phone sends (see the protocol
+// sections in trein_data.h). They only touch the structs they are given, so
+// they don't depend on any window or layer.
+
+// Decode a STATION_LIST byte array. Known stations point straight at
+// all_stations; unknown ones are copied into the station pool.
+bool protocol_decode_station_list(const uint8_t *data, uint16_t length, StationData *stations);
+
+// Decode a TRIP_DATA byte array. Returns false if the payload has an unknown
+// version or is shorter than its header claims.
+bool protocol_decode_trip_data(const uint8_t *data, uint16_t length, TripData *trips);
+
+// Apply a TRIP_DELTA byte array to one loaded trip. Returns the TRIP_DELTA_*
+// mask of the fields that changed and sets index to the patched trip, or
+// returns 0 if the delta was rejected.
+uint8_t protocol_apply_trip_delta(const uint8_t *data, uint16_t length, TripData *trips, int *index);
@@ -0,0 +1,73 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "reminder.h"
+
+_Static_assert(sizeof(Reminder) <= PERSIST_DATA_MAX_LENGTH, "Reminder does not fit in one persist value");
+
+int reminder_lead_minutes(void) {
+  return persist_exists(PERSIST_KEY_REMINDER_LEAD) ? persist_read_int(PERSIST_KEY_REMINDER_LEAD) : DEFAULT_REMINDER_LEAD_MINUTES;
+}
+
+void reminder_set_lead_minutes(int minutes) {
+  if (minutes < 0) { minutes = 0; }
+  if (minutes > MAX_REMINDER_LEAD_MINUTES) { minutes = MAX_REMINDER_LEAD_MINUTES; }
+  persist_write_int(PERSIST_KEY_REMINDER_LEAD, minutes);
+}
+
+static bool prv_load(Reminder *reminder) {
+  return persist_read_data(PERSIST_KEY_REMINDER, reminder, sizeof(Reminder)) == (int)sizeof(Reminder);
+}
+
+bool reminder_schedule(const SelectedJourney *journey, const TripData *trips, int index, time_t now) {
+  const time_t wake_at = trips->departures[index] - reminder_lead_minutes() * 60;
+  if (wake_at <= now || (trips->flags[index] & TRIP_FLAG_CANCELLED)) { return false; }
+
+  Reminder reminder;
+  if (prv_load(&reminder)) {
+    wakeup_cancel(reminder.wakeup_id);
+  }
+
+  memset(&reminder, 0, sizeof(reminder));
+  strncpy(reminder.start_code, journey->start_station_code, sizeof(reminder.start_code) - 1);
+  strncpy(reminder.dest_code, journey->dest_station_code, sizeof(reminder.dest_code) - 1);
+  strncpy(reminder.dest_name, journey->dest_station_name, sizeof(reminder.dest_name) - 1);
+  reminder.planned_departure = trips->planned_departures[index];
+  reminder.departure = trips->departures[index];
+  reminder.delay = trips->delays[index];
+  reminder.flags = trips->flags[index];
+  strncpy(reminder.platform, trips->platform[index], sizeof(reminder.platform) - 1);
+
+  // The cookie ties the wakeup to this reminder
+  reminder.wakeup_id = wakeup_schedule(wake_at, reminder.planned_departure, true);
+  if (reminder.wakeup_id < 0) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Wakeup refused: %d", (int)reminder.wakeup_id);
+    persist_delete(PERSIST_KEY_REMINDER);
+    return false;
+  }
+  persist_write_data(PERSIST_KEY_REMINDER, &reminder, sizeof(reminder));
+  return true;
+}
+
+bool reminder_take_launch(Reminder *reminder) {
+  WakeupId id;
+  int32_t cookie;
+  if (launch_reason() != APP_LAUNCH_WAKEUP || !wakeup_get_launch_event(&id, &cookie)) { return false; }
+
+  const bool found = prv_load(reminder) && reminder->planned_departure == cookie;
+  persist_delete(PERSIST_KEY_REMINDER);
+  return found;
+}
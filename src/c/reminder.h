@@ -0,0 +1,36 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <pebble.h>
+#include "trein_data.h"
+
+// "Leave now" reminders. Scheduling one stores the trip under
+// PERSIST_KEY_REMINDER and sets a wakeup a lead time before its departure, so
+// the app can exit instead of keeping the countdown running. Only one
+// reminder is kept; scheduling another replaces it.
+
+// Schedule a reminder for one trip. Returns false if the train leaves within
+// the lead time or the system refused the wakeup.
+bool reminder_schedule(const SelectedJourney *journey, const TripData *trips, int index, time_t now);
+
+// Take the reminder that woke the app. Returns false if the app was not
+// launched by a reminder wakeup or the reminder is gone.
+bool reminder_take_launch(Reminder *reminder);
+
+// Lead time in minutes, DEFAULT_REMINDER_LEAD_MINUTES until the phone sets one
+int reminder_lead_minutes(void);
+void reminder_set_lead_minutes(int minutes);
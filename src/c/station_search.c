@@ -0,0 +1,99 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "station_search.h"
+#include "stations.h"
+
+// Matches str.lower() in tools/generate_stations.py for the ASCII names we have
+static char prv_lower(char c) {
+  return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+}
+
+// Compare the first length characters of name with prefix, ignoring case. A
+// name shorter than the prefix sorts before it, like it does in the table.
+static int prv_compare_prefix(const char *name, const char *prefix, size_t length) {
+  for (size_t i = 0; i < length; i++) {
+    unsigned char a = prv_lower(name[i]);
+    unsigned char b = prv_lower(prefix[i]);
+    if (a != b) { return a - b; }
+  }
+  return 0;
+}
+
+// Name of a station as it is sorted in all_stations, without its article
+static const char *prv_sort_name(const Station *station) {
+  const char *name = station_name(station);
+  for (int i = 0; i < NUM_STATION_ARTICLES; i++) {
+    size_t length = strlen(station_articles[i]);
+    if (strncmp(name, station_articles[i], length) == 0) {
+      return name + length;
+    }
+  }
+  return name;
+}
+
+static const char *prv_key(bool articles, uint16_t i) {
+  return articles ? station_name(&all_stations[station_article_index[i]]) : prv_sort_name(&all_stations[i]);
+}
+
+// Narrow [*start, *start + *count) to the keys starting with prefix
+static void prv_narrow(bool articles, uint16_t *start, uint16_t *count, const char *prefix, size_t length) {
+  // First key not sorting before the prefix
+  uint16_t low = *start, high = *start + *count;
+  while (low < high) {
+    uint16_t mid = low + (high - low) / 2;
+    if (prv_compare_prefix(prv_key(articles, mid), prefix, length) < 0) { low = mid + 1; } else { high = mid; }
+  }
+  uint16_t first = low;
+
+  // First key sorting after the prefix
+  high = *start + *count;
+  while (low < high) {
+    uint16_t mid = low + (high - low) / 2;
+    if (prv_compare_prefix(prv_key(articles, mid), prefix, length) <= 0) { low = mid + 1; } else { high = mid; }
+  }
+  *start = first;
+  *count = low - first;
+}
+
+void station_search_reset(StationSearchRange *range) {
+  range->start = 0;
+  range->count = NUM_STATIONS;
+  range->article_start = 0;
+  range->article_count = NUM_STATION_ARTICLE_INDEX;
+}
+
+void station_search_narrow(StationSearchRange *range, const char *prefix) {
+  size_t length = strlen(prefix);
+  prv_narrow(false, &range->start, &range->count, prefix, length);
+
+  uint16_t article_start = range->article_start, article_count = range->article_count;
+  prv_narrow(true, &article_start, &article_count, prefix, length);
+  range->article_start = article_start;
+  range->article_count = article_count;
+}
+
+uint16_t station_search_count(const StationSearchRange *range) {
+  return range->count + range->article_count;
+}
+
+uint16_t station_search_result(const StationSearchRange *range, uint16_t n) {
+  if (n < range->count) {
+    return range->start + n;
+  }
+  return station_article_index[range->article_start + n - range->count];
+}
@@ -0,0 +1,47 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <pebble.h>
+
+// Case-insensitive prefix search over all_stations. all_stations is sorted on
+// station names without their article ("De Vink" sorts as "Vink"), and
+// station_article_index lists the stations with an article sorted on their
+// full name, so the stations matching a prefix are one contiguous range in
+// each. Narrowing a range to a longer prefix is a binary search inside it.
+
+// The stations matching a prefix
+typedef struct {
+  uint16_t start;          // First match in all_stations
+  uint16_t count;
+  uint8_t article_start;   // First match in station_article_index
+  uint8_t article_count;
+} StationSearchRange;
+
+// Reset range to match every station (the empty prefix). Stations with an
+// article are in both parts of this range, so only list narrowed ranges.
+void station_search_reset(StationSearchRange *range);
+
+// Narrow range to the stations starting with prefix. range must hold the
+// matches for prefix minus its last character.
+void station_search_narrow(StationSearchRange *range, const char *prefix);
+
+// Number of stations in range
+uint16_t station_search_count(const StationSearchRange *range);
+
+// Index into all_stations of the nth station in range
+uint16_t station_search_result(const StationSearchRange *range, uint16_t n);
@@ -0,0 +1,50 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define STATION_TABLE_DEFINITIONS
+#include "stations.h"
+
+// Pack a code of up to four characters into a little-endian key, matching
+// pack_code() in tools/generate_stations.py. Returns false for longer codes.
+static bool prv_pack_code(const char *code, uint32_t *key) {
+  *key = 0;
+  for (int i = 0; code[i] != '\0'; i++) {
+    if (i == 4) { return false; }
+    *key |= (uint32_t)(uint8_t)code[i] << (8 * i);
+  }
+  return true;
+}
+
+// Must stay identical to hash_code() in tools/generate_stations.py
+static uint32_t prv_hash(uint32_t key, uint32_t seed) {
+  uint32_t x = key ^ (seed * 0x9E3779B9u);
+  x ^= x >> 16;
+  x *= 0x85EBCA6Bu;
+  x ^= x >> 13;
+  x *= 0xC2B2AE35u;
+  x ^= x >> 16;
+  return x;
+}
+
+int station_index_for_code(const char *code) {
+  uint32_t key;
+  if (!prv_pack_code(code, &key)) { return -1; }
+  const uint32_t seed = station_hash_seeds[prv_hash(key, 0) % STATION_HASH_BUCKETS];
+  const uint16_t index = station_hash_slots[prv_hash(key, seed) % NUM_STATIONS];
+  // Codes outside the table hash to some slot too, so confirm the match
+  return (strcmp(station_code(&all_stations[index]), code) == 0) ? index : -1;
+}
@@ -0,0 +1,205 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "timetable.h"
+
+#define SECONDS_PER_DAY (24 * 60 * 60)
+#define RECORDS_PER_READ 32  // Departures read from the timetable at a time
+
+// Where a timetable is read from: the resource built into the app, or the
+// copy synced from the phone, which lives in persist pages
+typedef struct {
+  ResHandle resource;  // NULL for the synced copy
+  uint32_t length;
+} TimetableSource;
+
+typedef struct {
+  uint32_t block_offset;
+  uint16_t departure_count;
+  uint8_t platform_count;
+  uint8_t service_count;
+} TimetableRoute;
+
+static uint16_t prv_read_uint16(const uint8_t *bytes) {
+  return bytes[0] | (bytes[1] << 8);
+}
+
+static uint32_t prv_read_uint32(const uint8_t *bytes) {
+  return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+static int prv_page_count(uint32_t length) {
+  return (length + TIMETABLE_PAGE_SIZE - 1) / TIMETABLE_PAGE_SIZE;
+}
+
+// Read a byte range of the timetable, false if it runs past the end
+static bool prv_read(const TimetableSource *source, uint32_t offset, uint8_t *buffer, size_t length) {
+  if (offset + length > source->length) { return false; }
+  if (source->resource) {
+    return resource_load_byte_range(source->resource, offset, buffer, length) == length;
+  }
+
+  uint8_t page[TIMETABLE_PAGE_SIZE];
+  while (length > 0) {
+    const uint32_t page_offset = offset % TIMETABLE_PAGE_SIZE;
+    size_t part = TIMETABLE_PAGE_SIZE - page_offset;
+    if (part > length) { part = length; }
+    const int read = persist_read_data(PERSIST_KEY_TIMETABLE_BASE + offset / TIMETABLE_PAGE_SIZE, page, sizeof(page));
+    if (read < (int)(page_offset + part)) { return false; }
+    memcpy(buffer, page + page_offset, part);
+    buffer += part;
+    offset += part;
+    length -= part;
+  }
+  return true;
+}
+
+static bool prv_valid_header(const uint8_t *header) {
+  return header[0] == 'T' && header[1] == 'T' && header[2] == TIMETABLE_VERSION;
+}
+
+static bool prv_find_route(const TimetableSource *source, int from_station, int to_station, TimetableRoute *route) {
+  uint8_t header[TIMETABLE_HEADER_SIZE];
+  if (!prv_read(source, 0, header, sizeof(header)) || !prv_valid_header(header)) { return false; }
+
+  uint8_t entry[TIMETABLE_ROUTE_SIZE];
+  for (int i = 0; i < header[3]; i++) {
+    uint32_t offset = TIMETABLE_HEADER_SIZE + i * TIMETABLE_ROUTE_SIZE;
+    if (!prv_read(source, offset, entry, sizeof(entry))) { return false; }
+    if (prv_read_uint16(entry) == from_station && prv_read_uint16(entry + 2) == to_station) {
+      route->block_offset = prv_read_uint32(entry + 4);
+      route->departure_count = prv_read_uint16(entry + 8);
+      route->platform_count = entry[10];
+      route->service_count = entry[11];
+      return route->service_count <= TIMETABLE_MAX_SERVICES;
+    }
+  }
+  return false;
+}
+
+// Copy a NUL padded platform of the route into a TripData slot
+static void prv_read_platform(const TimetableSource *source, const TimetableRoute *route, uint8_t index, char *platform) {
+  uint8_t field[TIMETABLE_PLATFORM_SIZE];
+  platform[0] = '\0';
+  if (index >= route->platform_count) { return; }
+  uint32_t offset = route->block_offset + index * TIMETABLE_PLATFORM_SIZE;
+  if (!prv_read(source, offset, field, sizeof(field))) { return; }
+
+  int length = 0;
+  while (length < TIMETABLE_PLATFORM_SIZE && length < MAX_PLATFORM_LENGTH - 1 && field[length] != '\0') {
+    platform[length] = field[length];
+    length++;
+  }
+  platform[length] = '\0';
+}
+
+static bool prv_fill_trips(const TimetableSource *source, int from_station, int to_station, time_t now, TripData *trips) {
+  TimetableRoute route;
+  if (!prv_find_route(source, from_station, to_station, &route) || route.departure_count == 0) { return false; }
+
+  uint8_t services[TIMETABLE_MAX_SERVICES * TIMETABLE_SERVICE_SIZE];
+  uint32_t services_offset = route.block_offset + route.platform_count * TIMETABLE_PLATFORM_SIZE;
+  if (!prv_read(source, services_offset, services, route.service_count * TIMETABLE_SERVICE_SIZE)) { return false; }
+
+  uint8_t hour_index[TIMETABLE_HOUR_INDEX_COUNT * 2];
+  uint32_t hour_index_offset = services_offset + route.service_count * TIMETABLE_SERVICE_SIZE;
+  if (!prv_read(source, hour_index_offset, hour_index, sizeof(hour_index))) { return false; }
+  uint32_t records_offset = hour_index_offset + sizeof(hour_index);
+
+  struct tm *local = localtime(&now);
+  const int weekday = local->tm_wday;
+  const int hour_now = local->tm_hour;
+  const time_t midnight = now - (local->tm_hour * 60 + local->tm_min) * 60 - local->tm_sec;
+
+  uint8_t records[RECORDS_PER_READ * TIMETABLE_RECORD_SIZE];
+  int count = 0;
+
+  // Today from the current hour on, then tomorrow from midnight
+  for (int day = 0; day < 2 && count < MAX_TRIPS; day++) {
+    const uint8_t day_bit = 1 << ((weekday + day) % 7);
+    int hour = (day == 0) ? hour_now : 0;
+    int record = prv_read_uint16(hour_index + hour * 2);
+
+    while (record < route.departure_count && count < MAX_TRIPS) {
+      int batch = route.departure_count - record;
+      if (batch > RECORDS_PER_READ) { batch = RECORDS_PER_READ; }
+      size_t length = batch * TIMETABLE_RECORD_SIZE;
+      if (!prv_read(source, records_offset + record * TIMETABLE_RECORD_SIZE, records, length)) { return false; }
+
+      for (int i = 0; i < batch && count < MAX_TRIPS; i++, record++) {
+        while (hour < 23 && record >= prv_read_uint16(hour_index + (hour + 1) * 2)) { hour++; }
+        const uint8_t *entry = records + i * TIMETABLE_RECORD_SIZE;
+        if (entry[1] >= route.service_count) { continue; }
+        const uint8_t *service = services + entry[1] * TIMETABLE_SERVICE_SIZE;
+        if (!(service[0] & day_bit)) { continue; }
+
+        const int departure = midnight + day * SECONDS_PER_DAY + (hour * 60 + entry[0]) * 60;
+        if (departure <= now) { continue; }
+
+        trips->departures[count] = departure;
+        trips->planned_departures[count] = departure;
+        trips->planned_arrivals[count] = departure + service[1] * 60;
+        trips->arrivals[count] = trips->planned_arrivals[count];
+        trips->delays[count] = 0;
+        trips->transfers[count] = service[2] >> 4;
+        trips->flags[count] = 0;
+        prv_read_platform(source, &route, service[2] & 0x0F, trips->platform[count]);
+        count++;
+      }
+    }
+  }
+
+  if (count == 0) { return false; }
+  trips->count = count;
+  return true;
+}
+
+bool timetable_fill_trips(int from_station, int to_station, time_t now, TripData *trips) {
+  // The user's own routes take precedence over the built-in ones
+  const TimetableSource synced = { .resource = NULL, .length = persist_read_int(PERSIST_KEY_TIMETABLE_LENGTH) };
+  if (synced.length > 0 && prv_fill_trips(&synced, from_station, to_station, now, trips)) { return true; }
+
+  ResHandle handle = resource_get_handle(RESOURCE_ID_TIMETABLE);
+  const TimetableSource built_in = { .resource = handle, .length = resource_size(handle) };
+  return prv_fill_trips(&built_in, from_station, to_station, now, trips);
+}
+
+bool timetable_store(const uint8_t *data, uint16_t length) {
+  if (length < TIMETABLE_HEADER_SIZE || length > TIMETABLE_MAX_SYNCED_LENGTH || !prv_valid_header(data)) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Rejected timetable of %d bytes", length);
+    return false;
+  }
+
+  // Drop the length first, so a half written timetable is never read
+  const int old_pages = prv_page_count(persist_read_int(PERSIST_KEY_TIMETABLE_LENGTH));
+  persist_delete(PERSIST_KEY_TIMETABLE_LENGTH);
+  const int pages = (data[3] == 0) ? 0 : prv_page_count(length);  // No routes clears the timetable
+
+  for (int page = 0; page < pages; page++) {
+    const uint32_t offset = page * TIMETABLE_PAGE_SIZE;
+    const size_t part = (length - offset < TIMETABLE_PAGE_SIZE) ? length - offset : TIMETABLE_PAGE_SIZE;
+    if (persist_write_data(PERSIST_KEY_TIMETABLE_BASE + page, data + offset, part) != (int)part) {
+      APP_LOG(APP_LOG_LEVEL_ERROR, "Could not store timetable page %d", page);
+      return false;
+    }
+  }
+  for (int page = pages; page < old_pages; page++) {
+    persist_delete(PERSIST_KEY_TIMETABLE_BASE + page);
+  }
+
+  if (pages > 0) { persist_write_int(PERSIST_KEY_TIMETABLE_LENGTH, length); }
+  return true;
+}
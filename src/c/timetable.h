@@ -0,0 +1,35 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <pebble.h>
+#include "trein_data.h"
+
+// Offline timetable for when the phone cannot fetch live trips (see
+// "Timetable Resource" in trein_data.h). Routes synced from the phone are
+// looked up first, then the ones built into the resource. Both are read in
+// small slices, so a lookup costs the same RAM however many routes and
+// departures they hold.
+
+// Fill trips with the next scheduled departures between two all_stations
+// indices, today and tomorrow, after `now`. Returns false if the route is not
+// in the timetable or has no departures left.
+bool timetable_fill_trips(int from_station, int to_station, time_t now, TripData *trips);
+
+// Replace the synced timetable with one packed on the phone. A timetable
+// without routes removes it. Returns false if it is invalid or could not be
+// stored.
+bool timetable_store(const uint8_t *data, uint16_t length);
@@ -0,0 +1,55 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "trace.h"
+
+#ifdef TREIN_DEBUG
+
+void trace_mark(const char *step) {
+  time_t seconds;
+  uint16_t milliseconds;
+  time_ms(&seconds, &milliseconds);
+  APP_LOG(APP_LOG_LEVEL_INFO, "TRACE %s %ld.%03u", step, (long)seconds, milliseconds);
+}
+
+static time_t s_redraw_second;
+static unsigned int s_frames;
+static unsigned int s_layers;
+
+// Log the counts of the previous second once a redraw falls in a new one
+static void prv_count_redraw(void) {
+  const time_t now = time(NULL);
+  if (now == s_redraw_second) { return; }
+  if (s_frames || s_layers) {
+    APP_LOG(APP_LOG_LEVEL_INFO, "REDRAW %u frames %u layers", s_frames, s_layers);
+  }
+  s_redraw_second = now;
+  s_frames = 0;
+  s_layers = 0;
+}
+
+void trace_frame(void) {
+  prv_count_redraw();
+  s_frames++;
+  s_layers++;
+}
+
+void trace_layer_drawn(void) {
+  prv_count_redraw();
+  s_layers++;
+}
+
+#endif
@@ -0,0 +1,45 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <pebble.h>
+
+// Latency markers for tools/latency_benchmark.py, compiled in only when
+// building with TREIN_DEBUG=1 (see wscript). Each marker is logged as
+// "TRACE <step> <epoch seconds>.<milliseconds>".
+
+#define TRACE_APP_START "app_start"
+#define TRACE_STATIONS_REQUESTED "stations_requested"
+#define TRACE_STATION_MENU "station_menu"
+#define TRACE_TRIP_REQUESTED "trip_requested"
+#define TRACE_COUNTDOWN "countdown"
+#define TRACE_TRIPS_RECEIVED "trips_received"
+
+// Redraw counters for comparing rendering cost between builds and platforms.
+// A window's background update proc calls trace_frame() once per redraw, other
+// update procs call trace_layer_drawn(). Each second with redraws is logged as
+// "REDRAW <frames> frames <layers> layers". TextLayers draw themselves and are
+// not counted.
+
+#ifdef TREIN_DEBUG
+void trace_mark(const char *step);
+void trace_frame(void);
+void trace_layer_drawn(void);
+#else
+#define trace_mark(step)
+#define trace_frame()
+#define trace_layer_drawn()
+#endif
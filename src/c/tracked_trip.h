@@ -0,0 +1,112 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stdint.h>
+
+// Shared between the app and the background worker (worker_src/c), which
+// only has pebble_worker.h. Include it after pebble.h or pebble_worker.h and
+// keep it free of app-only types.
+//
+// Tracking a trip stores a TrackedTrip under PERSIST_KEY_TRACKED_TRIP and
+// starts the worker. The worker counts down on minute ticks and launches the
+// app to alert at the reminder lead time and just before departure. While
+// the app is open it forwards live changes to the trip as TRACKING_MSG_UPDATE.
+// The open app already shows those changes, so the worker only stores them
+// and the alerts that were due when tracking started are marked as sent.
+//
+// Workers cannot vibrate or draw, since pebble_worker.h has neither the vibes
+// nor the UI APIs, so every alert is shown by the app. After the final alert,
+// or once the trip is cancelled, the worker marks the trip TRACKING_DONE. The
+// app then deletes the record and kills the worker once it has read it.
+
+#define PERSIST_KEY_REMINDER_LEAD 3
+#define PERSIST_KEY_TRACKED_TRIP 4
+
+#define DEFAULT_REMINDER_LEAD_MINUTES 5
+#define TRACKING_FINAL_LEAD_MINUTES 1
+
+#define TRACKED_TRIP_CODE_LENGTH 5       // MAX_STATION_CODE_LENGTH
+#define TRACKED_TRIP_NAME_LENGTH 32      // MAX_STATION_NAME_LENGTH
+#define TRACKED_TRIP_PLATFORM_LENGTH 5   // MAX_PLATFORM_LENGTH
+
+// TRIP_FLAG_CANCELLED, for the worker which has no trein_data.h
+#define TRACKED_TRIP_CANCELLED 0x01
+
+// alerts_sent bits, cleared again when a delay pushes the departure back
+#define TRACKING_ALERT_LEAD 0x01
+#define TRACKING_ALERT_FINAL 0x02
+#define TRACKING_DONE 0x04  // Nothing left to alert, the app ends tracking
+
+typedef struct {
+  char start_code[TRACKED_TRIP_CODE_LENGTH];
+  char dest_code[TRACKED_TRIP_CODE_LENGTH];
+  char dest_name[TRACKED_TRIP_NAME_LENGTH];
+  int32_t planned_departure;  // Identifies the trip in fresh TRIP_DATA
+  int16_t delay;              // Minutes, departure is planned_departure + delay
+  uint8_t flags;              // TRIP_FLAG_* bits
+  char platform[TRACKED_TRIP_PLATFORM_LENGTH];
+  uint8_t alerts_sent;        // TRACKING_ALERT_* bits
+} TrackedTrip;
+
+// TRACKING_ALERT_* bits that are due at now, given the lead in minutes
+static inline uint8_t tracking_alerts_due(const TrackedTrip *trip, time_t now, int lead_minutes) {
+  const time_t departure = trip->planned_departure + trip->delay * 60;
+  const int minutes_left = (departure > now) ? (departure - now + 59) / 60 : 0;
+  uint8_t due = 0;
+  if (minutes_left <= lead_minutes) {
+    due |= TRACKING_ALERT_LEAD;
+  }
+  if (minutes_left <= TRACKING_FINAL_LEAD_MINUTES) {
+    due |= TRACKING_ALERT_FINAL;
+  }
+  return due;
+}
+
+// --- Worker Messages ---
+// Sent with app_worker_send_message, the type is the message type.
+typedef enum {
+  TRACKING_MSG_TRACK = 1,  // App to worker: reload PERSIST_KEY_TRACKED_TRIP
+  TRACKING_MSG_UPDATE,     // App to worker: the tracked trip changed
+  TRACKING_MSG_ALERT,      // Worker to app: show the alert for the tracked trip
+} TrackingMessageType;
+
+// An update fits one AppWorkerMessage. data0 holds the delay in minutes in
+// its low 12 bits (signed, so up to 2047) and the flags in its top 4 bits;
+// data1 and data2 hold the four platform characters, low byte first.
+#define TRACKING_DELAY_BITS 12
+#define TRACKING_DELAY_LIMIT ((1 << (TRACKING_DELAY_BITS - 1)) - 1)
+
+static inline void tracking_pack_update(const TrackedTrip *trip, AppWorkerMessage *message) {
+  int delay = trip->delay;
+  if (delay > TRACKING_DELAY_LIMIT) { delay = TRACKING_DELAY_LIMIT; }
+  if (delay < -TRACKING_DELAY_LIMIT) { delay = -TRACKING_DELAY_LIMIT; }
+  message->data0 = ((uint16_t)delay & ((1 << TRACKING_DELAY_BITS) - 1)) | ((uint16_t)(trip->flags & 0x0F) << TRACKING_DELAY_BITS);
+  message->data1 = (uint8_t)trip->platform[0] | ((uint16_t)(uint8_t)trip->platform[1] << 8);
+  message->data2 = (uint8_t)trip->platform[2] | ((uint16_t)(uint8_t)trip->platform[3] << 8);
+}
+
+static inline void tracking_unpack_update(const AppWorkerMessage *message, TrackedTrip *trip) {
+  int delay = message->data0 & ((1 << TRACKING_DELAY_BITS) - 1);
+  if (delay > TRACKING_DELAY_LIMIT) { delay -= 1 << TRACKING_DELAY_BITS; }
+  trip->delay = delay;
+  trip->flags = message->data0 >> TRACKING_DELAY_BITS;
+  trip->platform[0] = message->data1 & 0xFF;
+  trip->platform[1] = message->data1 >> 8;
+  trip->platform[2] = message->data2 & 0xFF;
+  trip->platform[3] = message->data2 >> 8;
+  trip->platform[4] = '\0';
+}
@@ -0,0 +1,132 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "tracking.h"
+#include "reminder.h"
+
+_Static_assert(TRACKED_TRIP_CODE_LENGTH == MAX_STATION_CODE_LENGTH, "TrackedTrip code length");
+_Static_assert(TRACKED_TRIP_NAME_LENGTH == MAX_STATION_NAME_LENGTH, "TrackedTrip name length");
+_Static_assert(TRACKED_TRIP_PLATFORM_LENGTH == MAX_PLATFORM_LENGTH, "TrackedTrip platform length");
+_Static_assert(TRACKED_TRIP_CANCELLED == TRIP_FLAG_CANCELLED, "TrackedTrip cancelled flag");
+_Static_assert(TRACKED_TRIP_PLATFORM_LENGTH - 1 == 4, "Updates pack four platform characters");
+
+static bool prv_read(TrackedTrip *trip) {
+  return persist_read_data(PERSIST_KEY_TRACKED_TRIP, trip, sizeof(TrackedTrip)) == (int)sizeof(TrackedTrip);
+}
+
+static bool prv_matches(const TrackedTrip *trip, const SelectedJourney *journey, int planned_departure) {
+  return trip->planned_departure == planned_departure &&
+         strncmp(trip->start_code, journey->start_station_code, sizeof(trip->start_code)) == 0 &&
+         strncmp(trip->dest_code, journey->dest_station_code, sizeof(trip->dest_code)) == 0;
+}
+
+bool tracking_start(const SelectedJourney *journey, const TripData *trips, int index, time_t now) {
+  if (index < 0 || index >= trips->count) { return false; }
+  if (trips->departures[index] <= now + TRACKING_FINAL_LEAD_MINUTES * 60 ||
+      (trips->flags[index] & TRIP_FLAG_CANCELLED)) { return false; }
+
+  TrackedTrip trip;
+  memset(&trip, 0, sizeof(trip));
+  strncpy(trip.start_code, journey->start_station_code, sizeof(trip.start_code) - 1);
+  strncpy(trip.dest_code, journey->dest_station_code, sizeof(trip.dest_code) - 1);
+  strncpy(trip.dest_name, journey->dest_station_name, sizeof(trip.dest_name) - 1);
+  trip.planned_departure = trips->planned_departures[index];
+  trip.delay = trips->delays[index];
+  trip.flags = trips->flags[index];
+  strncpy(trip.platform, trips->platform[index], sizeof(trip.platform) - 1);
+  // The countdown is on screen, so a reminder that is already due is not
+  // raised again over it
+  trip.alerts_sent = tracking_alerts_due(&trip, now, reminder_lead_minutes());
+  persist_write_data(PERSIST_KEY_TRACKED_TRIP, &trip, sizeof(trip));
+
+  // A worker that is already running picks the new trip up from persist
+  switch (app_worker_launch()) {
+    case APP_WORKER_RESULT_ALREADY_RUNNING: {
+      AppWorkerMessage message = { 0 };
+      app_worker_send_message(TRACKING_MSG_TRACK, &message);
+      return true;
+    }
+    case APP_WORKER_RESULT_SUCCESS:
+    case APP_WORKER_RESULT_ASKING_CONFIRMATION:
+      return true;
+    default:
+      persist_delete(PERSIST_KEY_TRACKED_TRIP);
+      return false;
+  }
+}
+
+void tracking_stop(void) {
+  persist_delete(PERSIST_KEY_TRACKED_TRIP);
+  app_worker_kill();
+}
+
+bool tracking_is_tracked(const SelectedJourney *journey, int planned_departure) {
+  TrackedTrip trip;
+  return prv_read(&trip) && prv_matches(&trip, journey, planned_departure);
+}
+
+bool tracking_update(const SelectedJourney *journey, const TripData *trips) {
+  TrackedTrip trip;
+  if (!prv_read(&trip) || !app_worker_is_running()) { return false; }
+
+  for (int i = 0; i < trips->count; i++) {
+    if (!prv_matches(&trip, journey, trips->planned_departures[i])) { continue; }
+
+    if (trip.delay == trips->delays[i] && trip.flags == trips->flags[i] &&
+        strncmp(trip.platform, trips->platform[i], sizeof(trip.platform)) == 0) { return false; }
+    // The worker stores the change, so the update stays one small message
+    TrackedTrip update = trip;
+    update.delay = trips->delays[i];
+    update.flags = trips->flags[i];
+    strncpy(update.platform, trips->platform[i], sizeof(update.platform) - 1);
+    AppWorkerMessage message;
+    tracking_pack_update(&update, &message);
+    app_worker_send_message(TRACKING_MSG_UPDATE, &message);
+    return true;
+  }
+  return false;
+}
+
+bool tracking_load(Reminder *reminder) {
+  TrackedTrip trip;
+  if (!prv_read(&trip)) { return false; }
+
+  memset(reminder, 0, sizeof(Reminder));
+  memcpy(reminder->start_code, trip.start_code, sizeof(reminder->start_code));
+  memcpy(reminder->dest_code, trip.dest_code, sizeof(reminder->dest_code));
+  memcpy(reminder->dest_name, trip.dest_name, sizeof(reminder->dest_name));
+  reminder->planned_departure = trip.planned_departure;
+  reminder->departure = trip.planned_departure + trip.delay * 60;
+  reminder->delay = trip.delay;
+  reminder->flags = trip.flags;
+  memcpy(reminder->platform, trip.platform, sizeof(reminder->platform));
+  reminder->wakeup_id = -1;
+
+  // The worker has nothing left to alert, it cannot exit by itself
+  if (trip.alerts_sent & TRACKING_DONE) {
+    tracking_stop();
+  }
+  return true;
+}
+
+void tracking_tidy(time_t now) {
+  TrackedTrip trip;
+  if (prv_read(&trip) && !(trip.alerts_sent & TRACKING_DONE) && trip.planned_departure + trip.delay * 60 > now) { return; }
+  persist_delete(PERSIST_KEY_TRACKED_TRIP);
+  if (app_worker_is_running()) {
+    app_worker_kill();
+  }
+}
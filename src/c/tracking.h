@@ -0,0 +1,44 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <pebble.h>
+#include "trein_data.h"
+
+// App side of background trip tracking, see tracked_trip.h. Tracking goes on
+// in the worker after the app exits, so one trip is tracked at a time.
+
+// Track one trip, replacing any trip tracked before, and start the worker.
+// Returns false if the trip leaves within the final alert, is cancelled, or
+// the worker could not be started.
+bool tracking_start(const SelectedJourney *journey, const TripData *trips, int index, time_t now);
+
+// Stop tracking and stop the worker
+void tracking_stop(void);
+
+// Whether this exact trip is being tracked
+bool tracking_is_tracked(const SelectedJourney *journey, int planned_departure);
+
+// Forward changes to the tracked trip found in fresh trip data to the worker.
+// Returns true if the tracked trip changed, for the app to buzz.
+bool tracking_update(const SelectedJourney *journey, const TripData *trips);
+
+// Load the tracked trip for display. Returns false if nothing is tracked.
+// A trip the worker is done with is deleted and the worker stopped.
+bool tracking_load(Reminder *reminder);
+
+// Stop a worker left running after its trip has gone, e.g. on launch
+void tracking_tidy(time_t now);
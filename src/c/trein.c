@@ -18,21 +18,34 @@
 #include <stdlib.h>
 #include "stations.h"
 #include "trein_data.h"
+#include "trip_cache.h"
+#include "trip_format.h"
+#include "trip_leg.h"
+#include "protocol.h"
+#include "heap_debug.h"
+#include "menu_host.h"
+#include "trace.h"
+#include "timetable.h"
+#include "glance.h"
+#include "reminder.h"
+#include "tracking.h"
 
 // --- Function Declarations ---
 static void prv_send_trip_request();
-static void prv_dest_menu_window_load(Window *window);
-static void prv_dest_menu_window_unload(Window *window);
-static void prv_alpha_menu_window_load(Window *window);
-static void prv_alpha_menu_window_unload(Window *window);
+static void prv_select_route(void);
+static void prv_send_selected_trip(int index);
+static void prv_flush_pending_messages(void);
+static void prv_push_dest_menu(void);
+static void prv_hint_destination_rows(int (*station_at)(int row), int row, int row_count);
+static void prv_cancel_prefetch_hint(void);
+static void prv_search_window_load(Window *window);
+static void prv_search_window_unload(Window *window);
+static void prv_push_search_results_menu(void);
 static void prv_countdown_window_load(Window *window);
 static void prv_countdown_window_unload(Window *window);
 static void prv_countdown_click_config_provider(void *context);
-static void prv_update_countdown_display();
-static void prv_update_countdown_display_animated(AnimationDirection direction);
-static void prv_animation_started_handler(Animation *animation, void *context);
-static void prv_animation_stopped_handler(Animation *animation, bool finished, void *context);
-static void prv_fade_in_stopped_handler(Animation *animation, bool finished, void *context);
+static void prv_prepare_trip_cards(void);
+static void prv_refresh_reminder(void);
 static void prv_trip_leg_layer_update_proc(Layer *layer, GContext *ctx);
 
 // --- Global Application Data ---
@@ -57,8 +70,34 @@ static void prv_bg_black_update_proc(Layer *layer, GContext *ctx) {
 }
 #endif
 
+// Draw the static part of the countdown window in one pass: both bars, the
+// background between them and the station names. Only the clock and the trip
+// cards on top of it change while the window is open.
+static void prv_countdown_chrome_update_proc(Layer *layer, GContext *ctx) {
+  trace_frame();
+  const GRect bounds = layer_get_bounds(layer);
+  const int bar_height = 40;
+  const GRect top_bar = GRect(0, 0, bounds.size.w, bar_height);
+  const GRect bottom_bar = GRect(0, bounds.size.h - bar_height, bounds.size.w, bar_height);
+
+  #ifdef PBL_COLOR
+    graphics_context_set_fill_color(ctx, GColorYellow);
+    graphics_fill_rect(ctx, GRect(0, bar_height, bounds.size.w, bounds.size.h - (bar_height * 2)), 0, GCornerNone);
+  #endif
+  graphics_context_set_fill_color(ctx, PBL_IF_COLOR_ELSE(GColorOxfordBlue, GColorBlack));
+  graphics_fill_rect(ctx, top_bar, 0, GCornerNone);
+  graphics_fill_rect(ctx, bottom_bar, 0, GCornerNone);
+
+  graphics_context_set_text_color(ctx, GColorWhite);
+  graphics_draw_text(ctx, s_app.journey.start_station_name, s_app.countdown_ui.station_font,
+                     GRect(0, 10, bounds.size.w, 30), GTextOverflowModeWordWrap, GTextAlignmentCenter, NULL);
+  graphics_draw_text(ctx, s_app.journey.dest_station_name, s_app.countdown_ui.station_font,
+                     GRect(0, bottom_bar.origin.y, bounds.size.w, 30), GTextOverflowModeWordWrap, GTextAlignmentCenter, NULL);
+}
+
 // Draw platform indicator with small blue square in top-left
 static void prv_platform_border_update_proc(Layer *layer, GContext *ctx) {
+  trace_layer_drawn();
   GRect bounds = layer_get_bounds(layer);
 
   // Fill with white background
@@ -79,263 +118,271 @@ static void prv_platform_border_update_proc(Layer *layer, GContext *ctx) {
 
 // All data moved to s_app structure defined in trein_data.h
 
-static void prv_countdown_timer_callback(void *data) {
-  time_t now = time(NULL);
-  int remaining_seconds = s_app.state.departure_time - now;
-  if (strncmp (s_app.trips.delay[s_app.journey.selected_trip_index],"Cancelled",9) == 0) {
-    text_layer_set_font(s_app.countdown_ui.countdown_layer, fonts_get_system_font(FONT_KEY_LECO_36_BOLD_NUMBERS));
-    text_layer_set_text(s_app.countdown_ui.countdown_layer, "--:--");
-    return;
-  }
-  if (remaining_seconds > 0) {
-    int hours = remaining_seconds / 3600;
-    int minutes = (remaining_seconds % 3600) / 60;
-    int seconds = remaining_seconds % 60;
+// --- Time Engine ---
+// A single tick handler drives both the clock and the countdown. It ticks every
+// minute while more than an hour is left (only HH:MM is shown then) and every
+// second during the last hour. Layers are only touched when their text changes.
+#define COUNTDOWN_SECONDS_THRESHOLD 3600
 
-    if (hours > 0) {
-      snprintf(s_app.buffers.countdown_buffer, sizeof(s_app.buffers.countdown_buffer), "%02d:%02d", hours, minutes);
-    } else {
-      snprintf(s_app.buffers.countdown_buffer, sizeof(s_app.buffers.countdown_buffer), "%02d:%02d", minutes, seconds);
-    }
-    text_layer_set_font(s_app.countdown_ui.countdown_layer, fonts_get_system_font(FONT_KEY_LECO_36_BOLD_NUMBERS));
-    text_layer_set_text(s_app.countdown_ui.countdown_layer, s_app.buffers.countdown_buffer);
-    s_app.state.countdown_timer = app_timer_register(1000, prv_countdown_timer_callback, NULL);
-  } else {
-    text_layer_set_font(s_app.countdown_ui.countdown_layer, fonts_get_system_font(FONT_KEY_GOTHIC_28_BOLD));
-    text_layer_set_text(s_app.countdown_ui.countdown_layer, "Departed");
-  }
+static void prv_tick_handler(struct tm *tick_time, TimeUnits units_changed);
+
+static void prv_set_tick_units(TimeUnits units) {
+  if (s_app.state.tick_units == units) { return; }
+  s_app.state.tick_units = units;
+  tick_timer_service_subscribe(units, prv_tick_handler);
 }
 
-static void prv_parse_time_and_start_timer() {
-  if (s_app.state.countdown_timer) {
-    app_timer_cancel(s_app.state.countdown_timer);
-    s_app.state.countdown_timer = NULL;
+static void prv_set_countdown_text(TripCard *card, const char *text, GFont font) {
+  if (card->countdown_font != font) {
+    card->countdown_font = font;
+    text_layer_set_font(card->countdown_layer, font);
   }
-  if (s_app.trips.count == 0 || s_app.trips.departures[s_app.journey.selected_trip_index] == 0) {
-    text_layer_set_text(s_app.countdown_ui.countdown_layer, "--:--");
-    return;
+  if (strcmp(card->countdown_buffer, text) != 0) {
+    snprintf(card->countdown_buffer, sizeof(card->countdown_buffer), "%s", text);
+    text_layer_set_text(card->countdown_layer, card->countdown_buffer);
   }
-  s_app.state.departure_time = s_app.trips.departures[s_app.journey.selected_trip_index];
-  prv_countdown_timer_callback(NULL);
 }
 
-static void prv_clock_timer_callback(void *data) {
-  time_t now = time(NULL);
-  struct tm *current_time = localtime(&now);
+// Refresh the countdown on a card. Returns the seconds left, see trip_format_countdown().
+static int prv_update_card_countdown(TripCard *card, time_t now) {
+  char countdown[sizeof(card->countdown_buffer)];
+  time_t departure = 0;
+  uint8_t flags = 0;
+  if (card->trip_index < s_app.trips.count) {
+    departure = s_app.trips.departures[card->trip_index];
+    flags = s_app.trips.flags[card->trip_index];
+  }
+  int remaining_seconds = trip_format_countdown(departure, flags, now, countdown, sizeof(countdown));
+  GFont font = (remaining_seconds == 0) ? fonts_get_system_font(FONT_KEY_GOTHIC_28_BOLD) : s_app.state.countdown_number_font;
+  prv_set_countdown_text(card, countdown, font);
+  return remaining_seconds;
+}
 
-  strftime(s_app.buffers.clock_buffer, sizeof(s_app.buffers.clock_buffer), "%H:%M", current_time);
-  text_layer_set_text(s_app.countdown_ui.clock_layer, s_app.buffers.clock_buffer);
+static void prv_update_countdown(time_t now) {
+  int remaining_seconds = prv_update_card_countdown(s_app.countdown_ui.current, now);
 
-  // Calculate milliseconds until next minute
-  int seconds_until_next_minute = 60 - current_time->tm_sec;
-  s_app.state.clock_timer = app_timer_register(seconds_until_next_minute * 1000, prv_clock_timer_callback, NULL);
+  // Switch to seconds one minute early so the first MM:SS value is not skipped
+  bool seconds = remaining_seconds > 0 && remaining_seconds <= COUNTDOWN_SECONDS_THRESHOLD + 60;
+  prv_set_tick_units(seconds ? SECOND_UNIT : MINUTE_UNIT);
+}
+
+static void prv_update_clock(struct tm *tick_time) {
+  char clock[sizeof(s_app.buffers.clock_buffer)];
+  strftime(clock, sizeof(clock), "%H:%M", tick_time);
+  if (strcmp(s_app.buffers.clock_buffer, clock) != 0) {
+    memcpy(s_app.buffers.clock_buffer, clock, sizeof(clock));
+    text_layer_set_text(s_app.countdown_ui.clock_layer, s_app.buffers.clock_buffer);
+  }
+}
+
+static void prv_tick_handler(struct tm *tick_time, TimeUnits units_changed) {
+  prv_update_clock(tick_time);
+  prv_update_countdown(time(NULL));
 }
 
 static void prv_trip_leg_layer_update_proc(Layer *layer, GContext *ctx) {
+  trace_layer_drawn();
+  const TripCard *card = *(TripCard **)layer_get_data(layer);
   int transfers = 0;
-  if (s_app.trips.count > 0 && s_app.trips.transfers[s_app.journey.selected_trip_index][0] != '\0') {
-    transfers = atoi(s_app.trips.transfers[s_app.journey.selected_trip_index]);
+  if (card->trip_index < s_app.trips.count) {
+    transfers = s_app.trips.transfers[card->trip_index];
   }
-  int num_legs = transfers + 1;
 
-  const int max_legs = 12;
-  if (num_legs > max_legs) {
-    num_legs = max_legs;
-  }
+  // Round layout is cached per leg count, so a redraw only issues draw calls
+  TripLegGeometry scratch;
+  const TripLegGeometry *geometry = trip_leg_geometry(
+      PBL_IF_ROUND_ELSE(layer_get_unobstructed_bounds(layer), layer_get_bounds(layer)), transfers, &scratch);
 
   graphics_context_set_stroke_width(ctx, 2);
-
+  graphics_context_set_stroke_color(ctx, GColorBlack);
+  for (int i = 0; i < geometry->leg_count; i++) {
 #ifdef PBL_ROUND
-  GRect unobstructed_bounds = layer_get_unobstructed_bounds(layer);
-
-  GPoint center = grect_center_point(&unobstructed_bounds);
-  int radius = (unobstructed_bounds.size.w / 2) - 8;
-  
-  int32_t total_angle = TRIG_MAX_ANGLE * 80 / 360;
-  int32_t center_angle = TRIG_MAX_ANGLE / 4;
-  int32_t start_angle = center_angle - (total_angle / 2);
-
-  int32_t angle_per_leg = total_angle / num_legs;
-  int32_t gap_angle = angle_per_leg / 8;
-
-  GRect polar_rect = GRect(center.x - radius, center.y - radius, radius * 2, radius * 2);
-  GPoint dot_points[max_legs * 2];
-
-  for (int i = 0; i < num_legs; i++) {
-    int32_t leg_start_angle_trig = start_angle + i * angle_per_leg + gap_angle;
-    int32_t leg_end_angle_trig = start_angle + (i + 1) * angle_per_leg - gap_angle;
-
-    GPoint p0 = gpoint_from_polar(polar_rect, GOvalScaleModeFitCircle, leg_start_angle_trig);
-    GPoint p1 = gpoint_from_polar(polar_rect, GOvalScaleModeFitCircle, leg_end_angle_trig);
-    
-    dot_points[i * 2] = p0;
-    dot_points[i * 2 + 1] = p1;
-
-    graphics_context_set_stroke_color(ctx, GColorBlack);
-    graphics_draw_arc(ctx, polar_rect, GOvalScaleModeFitCircle, leg_start_angle_trig, leg_end_angle_trig);
+    graphics_draw_arc(ctx, geometry->polar_rect, GOvalScaleModeFitCircle, geometry->angles[i * 2], geometry->angles[i * 2 + 1]);
+#else
+    graphics_draw_line(ctx, geometry->dots[i * 2], geometry->dots[i * 2 + 1]);
+#endif
   }
 
-  for (int i = 0; i < num_legs * 2; i++) {
-    GPoint p = dot_points[i];
-    graphics_context_set_fill_color(ctx, GColorBlack);
-    graphics_fill_circle(ctx, p, 4);
-    graphics_context_set_fill_color(ctx, GColorWhite);
-    graphics_fill_circle(ctx, p, 2);
+  // Black discs first, then their white centres, to switch colours only once
+  const int dot_count = geometry->leg_count * 2;
+  graphics_context_set_fill_color(ctx, GColorBlack);
+  for (int i = 0; i < dot_count; i++) {
+    graphics_fill_circle(ctx, geometry->dots[i], 4);
   }
-
-#else // PBL_RECT
-  GRect bounds = layer_get_bounds(layer);
-  int line_x = bounds.size.w - 12;
-  int total_height = bounds.size.h - 80;
-  int start_y = 40;
-
-  int height_per_leg = total_height / num_legs;
-  int gap_y = height_per_leg / 8;
-  GPoint dot_points[max_legs * 2];
-
-  for (int i = 0; i < num_legs; i++) {
-    int leg_start_y = start_y + i * height_per_leg + gap_y;
-    int leg_end_y = start_y + (i + 1) * height_per_leg - gap_y;
-    
-    GPoint p0 = GPoint(line_x, leg_start_y);
-    GPoint p1 = GPoint(line_x, leg_end_y);
-    
-    graphics_context_set_stroke_color(ctx, GColorBlack);
-    graphics_draw_line(ctx, p0, p1);
-
-    dot_points[i * 2] = p0;
-    dot_points[i * 2 + 1] = p1;
-  }
-
-  for (int i = 0; i < num_legs * 2; i++) {
-    GPoint p = dot_points[i];
-    graphics_context_set_fill_color(ctx, GColorBlack);
-    graphics_fill_circle(ctx, p, 4);
-    graphics_context_set_fill_color(ctx, GColorWhite);
-    graphics_fill_circle(ctx, p, 2);
+  graphics_context_set_fill_color(ctx, GColorWhite);
+  for (int i = 0; i < dot_count; i++) {
+    graphics_fill_circle(ctx, geometry->dots[i], 2);
   }
-#endif
 }
 
-static void prv_update_countdown_display() {
-  text_layer_set_text(s_app.countdown_ui.platform_number_layer, s_app.trips.platform[s_app.journey.selected_trip_index]);
-  if (strncmp (s_app.trips.delay[s_app.journey.selected_trip_index],"Cancelled",9) == 0) {
-    snprintf(s_app.buffers.delay_buffer, sizeof(s_app.buffers.delay_buffer), "%s", "");
-    text_layer_set_text(s_app.countdown_ui.delay_layer, s_app.buffers.delay_buffer);
-  }
-  else {
-    snprintf(s_app.buffers.delay_buffer, sizeof(s_app.buffers.delay_buffer), "%s", s_app.trips.delay[s_app.journey.selected_trip_index]);
-    text_layer_set_text(s_app.countdown_ui.delay_layer, s_app.buffers.delay_buffer);
+// --- Trip Carousel ---
+// The countdown window holds three trip cards: the selected trip and its
+// neighbours, filled in ahead of time. UP/DOWN slide the prepared neighbour in
+// and only the card that became the new far neighbour is filled again. Presses
+// made while a card is sliding are queued and played back faster.
+#define TRIP_CARD_ALL 0xFF            // prv_fill_trip_card() mask for every field
+#define TRIP_CARD_SLIDE_OFFSET 20
+#define TRIP_CARD_SLIDE_DURATION 400
+#define TRIP_CARD_QUEUED_SLIDE_DURATION 200
+
+// Fill in a card for a trip. mask selects the TRIP_DELTA_* fields to refresh,
+// TRIP_CARD_ALL refreshes the whole card.
+static void prv_fill_trip_card(TripCard *card, int index, uint8_t mask) {
+  card->trip_index = index;
+  if (mask & TRIP_DELTA_PLATFORM) {
+    // Platforms like "14b" only fit the box in a smaller font
+    const bool is_large_box = layer_get_bounds(text_layer_get_layer(card->platform_number_layer)).size.w > 20;
+    const bool is_long = strlen(s_app.trips.platform[index]) > 2;
+    text_layer_set_font(card->platform_number_layer, fonts_get_system_font(is_long ?
+        (is_large_box ? FONT_KEY_GOTHIC_18_BOLD : FONT_KEY_GOTHIC_14_BOLD) :
+        (is_large_box ? FONT_KEY_GOTHIC_24_BOLD : FONT_KEY_GOTHIC_18_BOLD)));
+    text_layer_set_text(card->platform_number_layer, s_app.trips.platform[index]);
   }
-
-  if (s_app.trips.planned_departures[s_app.journey.selected_trip_index][0] != '\0') {
-    strncpy(s_app.buffers.departure_time_buffer, &s_app.trips.planned_departures[s_app.journey.selected_trip_index][11], 5);
-    s_app.buffers.departure_time_buffer[5] = '\0';
-    text_layer_set_text(s_app.countdown_ui.departure_time_layer, s_app.buffers.departure_time_buffer);
+  if (mask & (TRIP_DELTA_DELAY | TRIP_DELTA_FLAGS)) {
+    trip_format_delay(&s_app.trips, index, card->delay_buffer, sizeof(card->delay_buffer));
+    text_layer_set_text(card->delay_layer, card->delay_buffer);
   }
-
-if (s_app.trips.planned_arrivals[s_app.journey.selected_trip_index][0] != '\0') {
-    if (strcmp(s_app.trips.planned_arrivals[s_app.journey.selected_trip_index], "--:--") == 0) {
-      snprintf(s_app.buffers.arrival_time_buffer, sizeof(s_app.buffers.arrival_time_buffer), "--:--");
-    } else {
-      strncpy(s_app.buffers.arrival_time_buffer, &s_app.trips.planned_arrivals[s_app.journey.selected_trip_index][11], 5);
-      s_app.buffers.arrival_time_buffer[5] = '\0';
-    }
-    text_layer_set_text(s_app.countdown_ui.arrival_time_layer, s_app.buffers.arrival_time_buffer);
+  if (mask == TRIP_CARD_ALL) {
+    trip_format_clock_time(s_app.trips.planned_departures[index], card->departure_time_buffer, sizeof(card->departure_time_buffer));
+    text_layer_set_text(card->departure_time_layer, card->departure_time_buffer);
+    trip_format_clock_time(s_app.trips.planned_arrivals[index], card->arrival_time_buffer, sizeof(card->arrival_time_buffer));
+    text_layer_set_text(card->arrival_time_layer, card->arrival_time_buffer);
+    layer_mark_dirty(card->trip_leg_layer);
   }
-
-  if(s_app.countdown_ui.trip_leg_layer) {
-    layer_mark_dirty(s_app.countdown_ui.trip_leg_layer);
+  if (mask & (TRIP_DELTA_DEPARTURE | TRIP_DELTA_FLAGS)) {
+    prv_update_card_countdown(card, time(NULL));
   }
-
-  prv_parse_time_and_start_timer();
 }
 
-// Animation callbacks
-static void prv_animation_started_handler(Animation *animation, void *context) {
-  // Animation started, we can safely null out the pointer
-  s_app.state.content_animation = NULL;
+// Trip index step away from the selected trip, wrapping around
+static int prv_neighbour_trip_index(int step) {
+  const int count = s_app.trips.count;
+  return (count > 0) ? (s_app.journey.selected_trip_index + step + count) % count : 0;
 }
 
-static void prv_animation_stopped_handler(Animation *animation, bool finished, void *context) {
-  if (!finished) {
-    s_app.state.is_animating = false;
-    return;
+// Show the selected trip on the current card and prepare both neighbours
+static void prv_prepare_trip_cards(void) {
+  CountdownWindowUI *ui = &s_app.countdown_ui;
+  prv_fill_trip_card(ui->current, s_app.journey.selected_trip_index, TRIP_CARD_ALL);
+  if (s_app.trips.count > 1) {
+    prv_fill_trip_card(ui->next, prv_neighbour_trip_index(1), TRIP_CARD_ALL);
+    prv_fill_trip_card(ui->previous, prv_neighbour_trip_index(-1), TRIP_CARD_ALL);
   }
+  prv_update_countdown(time(NULL));
+}
 
-  // Update all text content with new trip data
-  prv_update_countdown_display();
-
-  // Fade in from opposite direction
-  Layer *window_layer = window_get_root_layer(s_app.windows.countdown_window);
-  GRect bounds = layer_get_bounds(window_layer);
+static void prv_set_trip_card_offset(TripCard *card, int offset) {
+  GRect frame = layer_get_frame(card->layer);
+  frame.origin.y = offset;
+  layer_set_frame(card->layer, frame);
+}
 
-  // Come from opposite direction: if we slid up (UP button), new content comes from below
-  // if we slid down (DOWN button), new content comes from above
-  int offset = -20 * s_app.state.animation_direction;
-  GRect from_frame = GRect(bounds.origin.x, bounds.origin.y + offset, bounds.size.w, bounds.size.h);
-  GRect to_frame = bounds;
-
-  s_app.state.content_animation = property_animation_create_layer_frame(window_layer, &from_frame, &to_frame);
-  animation_set_duration((Animation*)s_app.state.content_animation, 200);
-  animation_set_curve((Animation*)s_app.state.content_animation, AnimationCurveEaseOut);
-  animation_set_handlers((Animation*)s_app.state.content_animation, (AnimationHandlers) {
-    .started = prv_animation_started_handler,
-    .stopped = prv_fade_in_stopped_handler
-  }, NULL);
-  animation_schedule((Animation*)s_app.state.content_animation);
+// First half: the current card slides away in the direction of the press.
+// Second half: the incoming card slides in from the opposite side.
+static void prv_trip_card_animation_update(Animation *animation, const AnimationProgress progress) {
+  CountdownWindowUI *ui = &s_app.countdown_ui;
+  const int direction = s_app.state.animation_direction;
+  const AnimationProgress half = ANIMATION_NORMALIZED_MAX / 2;
+  if (progress < half) {
+    prv_set_trip_card_offset(ui->current, TRIP_CARD_SLIDE_OFFSET * direction * (int32_t)progress / half);
+  } else {
+    layer_set_hidden(ui->current->layer, true);
+    layer_set_hidden(ui->incoming->layer, false);
+    prv_set_trip_card_offset(ui->incoming, -TRIP_CARD_SLIDE_OFFSET * direction * (int32_t)(ANIMATION_NORMALIZED_MAX - progress) / half);
+  }
 }
 
-static void prv_fade_in_stopped_handler(Animation *animation, bool finished, void *context) {
+static const AnimationImplementation s_trip_card_animation_implementation = {
+  .update = prv_trip_card_animation_update,
+};
+
+static void prv_step_trip(int step);
+
+static void prv_trip_card_animation_stopped_handler(Animation *animation, bool finished, void *context) {
+  CountdownWindowUI *ui = &s_app.countdown_ui;
+  s_app.state.card_animation = NULL;
+
+  // Settle on the incoming card even when the slide was cut short
+  prv_set_trip_card_offset(ui->current, 0);
+  layer_set_hidden(ui->current->layer, true);
+  prv_set_trip_card_offset(ui->incoming, 0);
+  layer_set_hidden(ui->incoming->layer, false);
+
+  // The card that was shown becomes the near neighbour as it is, and the old
+  // far neighbour is reused for the trip beyond the new selection
+  TripCard *recycled;
+  if (ui->incoming == ui->next) {
+    recycled = ui->previous;
+    ui->previous = ui->current;
+    ui->next = recycled;
+  } else {
+    recycled = ui->next;
+    ui->next = ui->current;
+    ui->previous = recycled;
+  }
+  ui->current = ui->incoming;
+  ui->incoming = NULL;
+  prv_fill_trip_card(recycled, prv_neighbour_trip_index(recycled == ui->next ? 1 : -1), TRIP_CARD_ALL);
   s_app.state.is_animating = false;
+  prv_update_countdown(time(NULL));
+
+  if (s_app.state.pending_trip_steps != 0) {
+    int queued_step = (s_app.state.pending_trip_steps > 0) ? 1 : -1;
+    s_app.state.pending_trip_steps -= queued_step;
+    prv_step_trip(queued_step);
+  }
 }
 
-static void prv_update_countdown_display_animated(AnimationDirection direction) {
-  if (s_app.state.is_animating) return;
+// Select the next (step 1) or previous (step -1) trip and slide its card in
+static void prv_step_trip(int step) {
+  CountdownWindowUI *ui = &s_app.countdown_ui;
+  s_app.journey.selected_trip_index = prv_neighbour_trip_index(step);
+  prv_send_selected_trip(s_app.journey.selected_trip_index);
 
+  // DOWN moves the content up, UP moves it down
+  s_app.state.animation_direction = (step > 0) ? ANIMATION_DIRECTION_UP : ANIMATION_DIRECTION_DOWN;
+  ui->incoming = (step > 0) ? ui->next : ui->previous;
   s_app.state.is_animating = true;
-  s_app.state.animation_direction = direction;
-
-  // Slide out in the direction of the button press
-  Layer *window_layer = window_get_root_layer(s_app.windows.countdown_window);
-  GRect bounds = layer_get_bounds(window_layer);
-  GRect from_frame = bounds;
 
-  // UP button: slide upward (negative), DOWN button: slide downward (positive)
-  int offset = 20 * direction;
-  GRect to_frame = GRect(bounds.origin.x, bounds.origin.y + offset, bounds.size.w, bounds.size.h);
+  Animation *animation = animation_create();
+  animation_set_implementation(animation, &s_trip_card_animation_implementation);
+  animation_set_duration(animation, s_app.state.pending_trip_steps ? TRIP_CARD_QUEUED_SLIDE_DURATION : TRIP_CARD_SLIDE_DURATION);
+  animation_set_curve(animation, AnimationCurveEaseInOut);
+  animation_set_handlers(animation, (AnimationHandlers) {
+    .stopped = prv_trip_card_animation_stopped_handler,
+  }, NULL);
+  s_app.state.card_animation = animation;
+  animation_schedule(animation);
+  heap_debug_sample(HEAP_SCOPE_COUNTDOWN);
+}
 
-  // Only destroy if animation still exists (hasn't been auto-freed)
-  if (s_app.state.content_animation) {
-    animation_unschedule((Animation*)s_app.state.content_animation);
-    property_animation_destroy(s_app.state.content_animation);
-    s_app.state.content_animation = NULL;
+// Cut a running slide short and drop queued presses
+static void prv_stop_trip_card_animation(void) {
+  s_app.state.pending_trip_steps = 0;
+  if (s_app.state.card_animation) {
+    animation_unschedule(s_app.state.card_animation);
   }
+}
 
-  s_app.state.content_animation = property_animation_create_layer_frame(window_layer, &from_frame, &to_frame);
-  animation_set_duration((Animation*)s_app.state.content_animation, 200);
-  animation_set_curve((Animation*)s_app.state.content_animation, AnimationCurveEaseIn);
-  animation_set_handlers((Animation*)s_app.state.content_animation, (AnimationHandlers) {
-    .started = prv_animation_started_handler,
-    .stopped = prv_animation_stopped_handler
-  }, NULL);
-  animation_schedule((Animation*)s_app.state.content_animation);
+static void prv_queue_trip_step(int step) {
+  const int count = s_app.trips.count;
+  if (count < 2) { return; }
+  if (s_app.state.is_animating) {
+    // Queue at most one lap of trips
+    if (abs(s_app.state.pending_trip_steps + step) < count) {
+      s_app.state.pending_trip_steps += step;
+    }
+    return;
+  }
+  prv_step_trip(step);
 }
 
 static void prv_countdown_down_click_handler(ClickRecognizerRef recognizer, void *context) {
-  if (s_app.trips.count > 0 && !s_app.state.is_animating) {
-    s_app.journey.selected_trip_index++;
-    if (s_app.journey.selected_trip_index >= s_app.trips.count) { s_app.journey.selected_trip_index = 0; }
-    prv_update_countdown_display_animated(ANIMATION_DIRECTION_UP);
-  }
+  prv_queue_trip_step(1);
 }
 
 static void prv_countdown_up_click_handler(ClickRecognizerRef recognizer, void *context) {
-  if (s_app.trips.count > 0 && !s_app.state.is_animating) {
-    s_app.journey.selected_trip_index--;
-    if (s_app.journey.selected_trip_index < 0) { s_app.journey.selected_trip_index = s_app.trips.count - 1; }
-    prv_update_countdown_display_animated(ANIMATION_DIRECTION_DOWN);
-  }
+  prv_queue_trip_step(-1);
 }
 
 static void prv_fallback_timer_callback(void *context) {
@@ -362,36 +409,27 @@ static void prv_menu_select_callback(MenuLayer *menu_layer, MenuIndex *cell_inde
   s_app.state.last_selected_index = cell_index->row;
   strncpy(s_app.journey.start_station_name, s_app.stations.names[cell_index->row], sizeof(s_app.journey.start_station_name) - 1);
   strncpy(s_app.journey.start_station_code, s_app.stations.codes[cell_index->row], sizeof(s_app.journey.start_station_code) - 1);
-  if (!s_app.windows.dest_menu_window) {
-    s_app.windows.dest_menu_window = window_create();
-    window_set_window_handlers(s_app.windows.dest_menu_window, (WindowHandlers) {
-      .load = prv_dest_menu_window_load, .unload = prv_dest_menu_window_unload,
-    });
-  }
-  window_stack_push(s_app.windows.dest_menu_window, true);
+  prv_push_dest_menu();
 }
 
-static void prv_menu_window_load(Window *window) {
-  Layer *window_layer = window_get_root_layer(window);
-  GRect bounds = layer_get_bounds(window_layer);
-  s_app.menu_layers.menu_layer = menu_layer_create(bounds);
-  menu_layer_set_click_config_onto_window(s_app.menu_layers.menu_layer, window);
-  menu_layer_set_callbacks(s_app.menu_layers.menu_layer, NULL, (MenuLayerCallbacks) {
+static const MenuHost s_station_menu_host = {
+  .window = &s_app.windows.menu_window,
+  .menu_layer = &s_app.menu_layers.menu_layer,
+  .callbacks = {
     .get_num_rows = prv_menu_get_num_rows_callback,
     .draw_row = prv_menu_draw_row_callback,
     .select_click = prv_menu_select_callback,
-  });
-  #ifdef PBL_COLOR
-  menu_layer_set_normal_colors(s_app.menu_layers.menu_layer, GColorYellow, GColorBlack);
-  menu_layer_set_highlight_colors(s_app.menu_layers.menu_layer, GColorOxfordBlue, GColorWhite);
-  #endif
-  layer_add_child(window_layer, menu_layer_get_layer(s_app.menu_layers.menu_layer));
-  MenuIndex index = MenuIndex(0, s_app.state.last_selected_index);
-  menu_layer_set_selected_index(s_app.menu_layers.menu_layer, index, MenuRowAlignCenter, false);
+  },
+  .selected_row = &s_app.state.last_selected_index,
+  .heap_scope = HEAP_SCOPE_MENU,
+};
+
+static void prv_select_destination(const Station *station) {
+  strncpy(s_app.journey.dest_station_code, station_code(station), sizeof(s_app.journey.dest_station_code) - 1);
+  strncpy(s_app.journey.dest_station_name, station_name(station), sizeof(s_app.journey.dest_station_name) - 1);
+  prv_select_route();
 }
 
-static void prv_menu_window_unload(Window *window) { menu_layer_destroy(s_app.menu_layers.menu_layer); }
-
 static uint16_t prv_alpha_menu_get_num_rows_callback(MenuLayer *menu_layer, uint16_t section_index, void *context) {
   return alphabet_index[s_app.state.selected_alphabet_index].count;
 }
@@ -399,40 +437,261 @@ static uint16_t prv_alpha_menu_get_num_rows_callback(MenuLayer *menu_layer, uint
 static void prv_alpha_menu_draw_row_callback(GContext *ctx, const Layer *cell_layer, MenuIndex *cell_index, void *context) {
   int station_index = alphabet_index[s_app.state.selected_alphabet_index].start_index + cell_index->row;
   const Station *station = &all_stations[station_index];
-  menu_cell_basic_draw(ctx, cell_layer, station->name, NULL, NULL);
+  menu_cell_basic_draw(ctx, cell_layer, station_name(station), NULL, NULL);
 }
 
 static void prv_alpha_menu_select_callback(MenuLayer *menu_layer, MenuIndex *cell_index, void *context) {
   int station_index = alphabet_index[s_app.state.selected_alphabet_index].start_index + cell_index->row;
   const Station *station = &all_stations[station_index];
-  strncpy(s_app.journey.dest_station_code, station->code, sizeof(s_app.journey.dest_station_code) - 1);
-  strncpy(s_app.journey.dest_station_name, station->name, sizeof(s_app.journey.dest_station_name) - 1);
-  prv_send_trip_request();
+  prv_select_destination(station);
 }
 
-static void prv_alpha_menu_window_load(Window *window) {
-  Layer *window_layer = window_get_root_layer(window);
-  GRect bounds = layer_get_bounds(window_layer);
-  s_app.menu_layers.alpha_menu_layer = menu_layer_create(bounds);
-  menu_layer_set_click_config_onto_window(s_app.menu_layers.alpha_menu_layer, window);
-  menu_layer_set_callbacks(s_app.menu_layers.alpha_menu_layer, NULL, (MenuLayerCallbacks) {
+static int prv_alpha_menu_station_at(int row) {
+  return alphabet_index[s_app.state.selected_alphabet_index].start_index + row;
+}
+
+static void prv_alpha_menu_selection_changed_callback(MenuLayer *menu_layer, MenuIndex new_index, MenuIndex old_index, void *context) {
+  prv_hint_destination_rows(prv_alpha_menu_station_at, new_index.row, alphabet_index[s_app.state.selected_alphabet_index].count);
+}
+
+static const MenuHost s_alpha_menu_host = {
+  .window = &s_app.windows.alpha_menu_window,
+  .menu_layer = &s_app.menu_layers.alpha_menu_layer,
+  .callbacks = {
     .get_num_rows = prv_alpha_menu_get_num_rows_callback,
     .draw_row = prv_alpha_menu_draw_row_callback,
     .select_click = prv_alpha_menu_select_callback,
-  });
+    .selection_changed = prv_alpha_menu_selection_changed_callback,
+  },
+  .heap_scope = HEAP_SCOPE_ALPHA_MENU,
+};
+
+// --- Station search ---
+// The prefix is entered one character at a time: UP/DOWN cycle through the
+// characters that still have matches, SELECT adds one and BACK removes one.
+// Holding SELECT, or narrowing to a handful of stations, lists the matches.
+
+static const StationSearchRange *prv_search_range(void) {
+  return &s_app.search.ranges[s_app.search.length];
+}
+
+// Number of stations matching the prefix extended with c
+static uint16_t prv_search_count_with(char c) {
+  if (s_app.search.length >= MAX_SEARCH_LENGTH) { return 0; }
+  StationSearchRange range = *prv_search_range();
+  s_app.search.prefix[s_app.search.length] = c;
+  s_app.search.prefix[s_app.search.length + 1] = '\0';
+  station_search_narrow(&range, s_app.search.prefix);
+  s_app.search.prefix[s_app.search.length] = '\0';
+  return station_search_count(&range);
+}
+
+// Move the candidate to the next character in direction that has matches,
+// or clear it when no character extends the prefix
+static void prv_search_step_candidate(int direction) {
+  const char *alphabet = SEARCH_ALPHABET;
+  const int size = strlen(alphabet);
+  const char *current = s_app.search.candidate ? strchr(alphabet, s_app.search.candidate) : NULL;
+  const int index = current ? current - alphabet : -1;
+  for (int step = 1; step <= size; step++) {
+    const int next = (((index + direction * step) % size) + size) % size;
+    if (prv_search_count_with(alphabet[next]) > 0) {
+      s_app.search.candidate = alphabet[next];
+      return;
+    }
+  }
+  s_app.search.candidate = '\0';
+}
+
+static void prv_search_update_display(void) {
+  if (s_app.search.candidate) {
+    snprintf(s_app.buffers.search_prefix_buffer, sizeof(s_app.buffers.search_prefix_buffer), "%s[%c]", s_app.search.prefix, s_app.search.candidate);
+  } else {
+    snprintf(s_app.buffers.search_prefix_buffer, sizeof(s_app.buffers.search_prefix_buffer), "%s", s_app.search.prefix);
+  }
+  text_layer_set_text(s_app.search_ui.prefix_layer, s_app.buffers.search_prefix_buffer);
+
+  const StationSearchRange *range = prv_search_range();
+  const uint16_t count = (s_app.search.length > 0) ? station_search_count(range) : NUM_STATIONS;
+  snprintf(s_app.buffers.search_count_buffer, sizeof(s_app.buffers.search_count_buffer), (count == 1) ? "%d station" : "%d stations", count);
+  text_layer_set_text(s_app.search_ui.count_layer, s_app.buffers.search_count_buffer);
+
+  s_app.buffers.search_preview_buffer[0] = '\0';
+  if (s_app.search.length > 0) {
+    size_t used = 0;
+    for (uint16_t i = 0; i < count && i < SEARCH_PREVIEW_COUNT; i++) {
+      const Station *station = &all_stations[station_search_result(range, i)];
+      used += snprintf(s_app.buffers.search_preview_buffer + used, sizeof(s_app.buffers.search_preview_buffer) - used,
+                       (i == 0) ? "%s" : "\n%s", station_name(station));
+      if (used >= sizeof(s_app.buffers.search_preview_buffer)) { break; }
+    }
+  }
+  text_layer_set_text(s_app.search_ui.preview_layer, s_app.buffers.search_preview_buffer);
+}
+
+static void prv_show_search_results(void) {
+  if (s_app.search.length == 0) { return; }
+  prv_push_search_results_menu();
+}
+
+static void prv_search_select_click_handler(ClickRecognizerRef recognizer, void *context) {
+  if (!s_app.search.candidate) { return; }
+  const uint8_t length = s_app.search.length;
+  s_app.search.prefix[length] = s_app.search.candidate;
+  s_app.search.prefix[length + 1] = '\0';
+  s_app.search.ranges[length + 1] = s_app.search.ranges[length];
+  station_search_narrow(&s_app.search.ranges[length + 1], s_app.search.prefix);
+  s_app.search.length = length + 1;
+
+  s_app.search.candidate = '\0';
+  prv_search_step_candidate(1);
+  prv_search_update_display();
+  if (station_search_count(prv_search_range()) <= SEARCH_AUTO_LIST_COUNT) {
+    prv_show_search_results();
+  }
+}
+
+static void prv_search_long_select_click_handler(ClickRecognizerRef recognizer, void *context) {
+  prv_show_search_results();
+}
+
+static void prv_search_back_click_handler(ClickRecognizerRef recognizer, void *context) {
+  if (s_app.search.length == 0) {
+    window_stack_pop(true);
+    return;
+  }
+  // Offer the removed character again so it can be changed with UP/DOWN
+  s_app.search.length--;
+  s_app.search.candidate = s_app.search.prefix[s_app.search.length];
+  s_app.search.prefix[s_app.search.length] = '\0';
+  prv_search_update_display();
+}
+
+static void prv_search_up_click_handler(ClickRecognizerRef recognizer, void *context) {
+  prv_search_step_candidate(-1);
+  prv_search_update_display();
+}
+
+static void prv_search_down_click_handler(ClickRecognizerRef recognizer, void *context) {
+  prv_search_step_candidate(1);
+  prv_search_update_display();
+}
+
+static void prv_search_click_config_provider(void *context) {
+  window_single_click_subscribe(BUTTON_ID_SELECT, prv_search_select_click_handler);
+  window_long_click_subscribe(BUTTON_ID_SELECT, 500, prv_search_long_select_click_handler, NULL);
+  window_single_click_subscribe(BUTTON_ID_BACK, prv_search_back_click_handler);
+  window_single_repeating_click_subscribe(BUTTON_ID_UP, 150, prv_search_up_click_handler);
+  window_single_repeating_click_subscribe(BUTTON_ID_DOWN, 150, prv_search_down_click_handler);
+}
+
+static void prv_search_window_load(Window *window) {
+  heap_debug_window_loading(HEAP_SCOPE_SEARCH);
+  Layer *window_layer = window_get_root_layer(window);
+  GRect bounds = layer_get_bounds(window_layer);
+  const int bar_height = 40;
+
+  s_app.search.length = 0;
+  s_app.search.prefix[0] = '\0';
+  s_app.search.candidate = '\0';
+  station_search_reset(&s_app.search.ranges[0]);
+  prv_search_step_candidate(1);
+
   #ifdef PBL_COLOR
-  menu_layer_set_normal_colors(s_app.menu_layers.alpha_menu_layer, GColorYellow, GColorBlack);
-  menu_layer_set_highlight_colors(s_app.menu_layers.alpha_menu_layer, GColorOxfordBlue, GColorWhite);
+    s_app.search_ui.bg_blue_layer = layer_create(GRect(0, 0, bounds.size.w, bar_height));
+    layer_set_update_proc(s_app.search_ui.bg_blue_layer, prv_bg_blue_update_proc);
+    layer_add_child(window_layer, s_app.search_ui.bg_blue_layer);
+    s_app.search_ui.bg_yellow_layer = layer_create(GRect(0, bar_height, bounds.size.w, bounds.size.h - bar_height));
+    layer_set_update_proc(s_app.search_ui.bg_yellow_layer, prv_bg_yellow_update_proc);
+    layer_add_child(window_layer, s_app.search_ui.bg_yellow_layer);
+  #else
+    s_app.search_ui.bg_blue_layer = layer_create(GRect(0, 0, bounds.size.w, bar_height));
+    layer_set_update_proc(s_app.search_ui.bg_blue_layer, prv_bg_black_update_proc);
+    layer_add_child(window_layer, s_app.search_ui.bg_blue_layer);
   #endif
-  layer_add_child(window_layer, menu_layer_get_layer(s_app.menu_layers.alpha_menu_layer));
+
+  s_app.search_ui.prefix_layer = text_layer_create(GRect(0, 2, bounds.size.w, bar_height - 4));
+  text_layer_set_font(s_app.search_ui.prefix_layer, fonts_get_system_font(FONT_KEY_GOTHIC_28_BOLD));
+  text_layer_set_text_alignment(s_app.search_ui.prefix_layer, GTextAlignmentCenter);
+  text_layer_set_background_color(s_app.search_ui.prefix_layer, GColorClear);
+  text_layer_set_text_color(s_app.search_ui.prefix_layer, GColorWhite);
+  layer_add_child(window_layer, text_layer_get_layer(s_app.search_ui.prefix_layer));
+
+  s_app.search_ui.count_layer = text_layer_create(GRect(0, bar_height + 2, bounds.size.w, 22));
+  text_layer_set_font(s_app.search_ui.count_layer, fonts_get_system_font(FONT_KEY_GOTHIC_18));
+  text_layer_set_text_alignment(s_app.search_ui.count_layer, GTextAlignmentCenter);
+  text_layer_set_background_color(s_app.search_ui.count_layer, GColorClear);
+  text_layer_set_text_color(s_app.search_ui.count_layer, GColorBlack);
+  layer_add_child(window_layer, text_layer_get_layer(s_app.search_ui.count_layer));
+
+  s_app.search_ui.preview_layer = text_layer_create(GRect(0, bar_height + 26, bounds.size.w, bounds.size.h - bar_height - 26));
+  text_layer_set_font(s_app.search_ui.preview_layer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
+  text_layer_set_text_alignment(s_app.search_ui.preview_layer, GTextAlignmentCenter);
+  text_layer_set_background_color(s_app.search_ui.preview_layer, GColorClear);
+  text_layer_set_text_color(s_app.search_ui.preview_layer, GColorBlack);
+  layer_add_child(window_layer, text_layer_get_layer(s_app.search_ui.preview_layer));
+
+  prv_search_update_display();
+
+  heap_debug_window_loaded(HEAP_SCOPE_SEARCH);
 }
 
-static void prv_alpha_menu_window_unload(Window *window) { menu_layer_destroy(s_app.menu_layers.alpha_menu_layer); }
+static void prv_search_window_unload(Window *window) {
+  text_layer_destroy(s_app.search_ui.prefix_layer);
+  text_layer_destroy(s_app.search_ui.count_layer);
+  text_layer_destroy(s_app.search_ui.preview_layer);
+  layer_destroy(s_app.search_ui.bg_blue_layer);
+  #ifdef PBL_COLOR
+    layer_destroy(s_app.search_ui.bg_yellow_layer);
+  #endif
+  window_destroy(window);
+  s_app.windows.search_window = NULL;
+  heap_debug_window_unloaded(HEAP_SCOPE_SEARCH);
+}
+
+static uint16_t prv_search_results_get_num_rows_callback(MenuLayer *menu_layer, uint16_t section_index, void *context) {
+  return station_search_count(prv_search_range());
+}
+
+static void prv_search_results_draw_row_callback(GContext *ctx, const Layer *cell_layer, MenuIndex *cell_index, void *context) {
+  const Station *station = &all_stations[station_search_result(prv_search_range(), cell_index->row)];
+  menu_cell_basic_draw(ctx, cell_layer, station_name(station), NULL, NULL);
+}
+
+static void prv_search_results_select_callback(MenuLayer *menu_layer, MenuIndex *cell_index, void *context) {
+  prv_select_destination(&all_stations[station_search_result(prv_search_range(), cell_index->row)]);
+}
+
+static int prv_search_results_station_at(int row) {
+  return station_search_result(prv_search_range(), row);
+}
+
+static void prv_search_results_selection_changed_callback(MenuLayer *menu_layer, MenuIndex new_index, MenuIndex old_index, void *context) {
+  prv_hint_destination_rows(prv_search_results_station_at, new_index.row, station_search_count(prv_search_range()));
+}
+
+static const MenuHost s_search_results_menu_host = {
+  .window = &s_app.windows.search_results_window,
+  .menu_layer = &s_app.menu_layers.search_results_menu_layer,
+  .callbacks = {
+    .get_num_rows = prv_search_results_get_num_rows_callback,
+    .draw_row = prv_search_results_draw_row_callback,
+    .select_click = prv_search_results_select_callback,
+    .selection_changed = prv_search_results_selection_changed_callback,
+  },
+  .heap_scope = HEAP_SCOPE_SEARCH_RESULTS,
+};
+
+static void prv_push_search_results_menu(void) {
+  menu_host_push(&s_search_results_menu_host);
+  prv_hint_destination_rows(prv_search_results_station_at, 0, station_search_count(prv_search_range()));
+}
 
 static uint16_t prv_dest_menu_get_num_sections_callback(MenuLayer *menu_layer, void *context) { return 2; }
 
 static uint16_t prv_dest_menu_get_num_rows_callback(MenuLayer *menu_layer, uint16_t section_index, void *context) {
-  return (section_index == 0) ? NUM_TOP_STATIONS : ALPHABET_INDEX_COUNT;
+  // The letters are preceded by the search entry
+  return (section_index == 0) ? NUM_TOP_STATIONS : ALPHABET_INDEX_COUNT + 1;
 }
 
 static void prv_dest_menu_draw_header_callback(GContext *ctx, const Layer *cell_layer, uint16_t section_index, void *context) {
@@ -442,10 +701,12 @@ static void prv_dest_menu_draw_header_callback(GContext *ctx, const Layer *cell_
 
 static void prv_dest_menu_draw_row_callback(GContext *ctx, const Layer *cell_layer, MenuIndex *cell_index, void *context) {
   if (cell_index->section == 0) {
-    const Station *station = &top_stations[cell_index->row];
-    menu_cell_basic_draw(ctx, cell_layer, station->name, NULL, NULL);
+    const Station *station = &all_stations[top_stations[cell_index->row]];
+    menu_cell_basic_draw(ctx, cell_layer, station_name(station), NULL, NULL);
+  } else if (cell_index->row == 0) {
+    menu_cell_basic_draw(ctx, cell_layer, "Search", NULL, NULL);
   } else {
-    s_app.buffers.letter_str[0] = alphabet_index[cell_index->row].letter;
+    s_app.buffers.letter_str[0] = alphabet_index[cell_index->row - 1].letter;
     s_app.buffers.letter_str[1] = '\0';
     menu_cell_basic_draw(ctx, cell_layer, s_app.buffers.letter_str, NULL, NULL);
   }
@@ -453,155 +714,477 @@ static void prv_dest_menu_draw_row_callback(GContext *ctx, const Layer *cell_lay
 
 static void prv_dest_menu_select_callback(MenuLayer *menu_layer, MenuIndex *cell_index, void *context) {
   if (cell_index->section == 0) {
-    const Station *station = &top_stations[cell_index->row];
-    strncpy(s_app.journey.dest_station_code, station->code, sizeof(s_app.journey.dest_station_code) - 1);
-    strncpy(s_app.journey.dest_station_name, station->name, sizeof(s_app.journey.dest_station_name) - 1);
-    prv_send_trip_request();
-  } else {
-    s_app.state.selected_alphabet_index = cell_index->row;
-    if (!s_app.windows.alpha_menu_window) {
-      s_app.windows.alpha_menu_window = window_create();
-      window_set_window_handlers(s_app.windows.alpha_menu_window, (WindowHandlers) {
-        .load = prv_alpha_menu_window_load, .unload = prv_alpha_menu_window_unload,
+    const Station *station = &all_stations[top_stations[cell_index->row]];
+    prv_select_destination(station);
+  } else if (cell_index->row == 0) {
+    if (!s_app.windows.search_window) {
+      s_app.windows.search_window = window_create();
+      window_set_click_config_provider(s_app.windows.search_window, prv_search_click_config_provider);
+      window_set_window_handlers(s_app.windows.search_window, (WindowHandlers) {
+        .load = prv_search_window_load, .unload = prv_search_window_unload,
       });
+      window_stack_push(s_app.windows.search_window, true);
     }
-    window_stack_push(s_app.windows.alpha_menu_window, true);
+  } else {
+    s_app.state.selected_alphabet_index = cell_index->row - 1;
+    menu_host_push(&s_alpha_menu_host);
+    prv_hint_destination_rows(prv_alpha_menu_station_at, 0, alphabet_index[s_app.state.selected_alphabet_index].count);
   }
 }
 
-static void prv_dest_menu_window_load(Window *window) {
-  Layer *window_layer = window_get_root_layer(window);
-  GRect bounds = layer_get_bounds(window_layer);
-  s_app.menu_layers.dest_menu_layer = menu_layer_create(bounds);
-  menu_layer_set_click_config_onto_window(s_app.menu_layers.dest_menu_layer, window);
-  menu_layer_set_callbacks(s_app.menu_layers.dest_menu_layer, NULL, (MenuLayerCallbacks) {
+static int prv_top_station_at(int row) {
+  return top_stations[row];
+}
+
+// Only the stations in the first section are hinted, the other rows open
+// another list
+static void prv_dest_menu_selection_changed_callback(MenuLayer *menu_layer, MenuIndex new_index, MenuIndex old_index, void *context) {
+  if (new_index.section != 0) { return; }
+  prv_hint_destination_rows(prv_top_station_at, new_index.row, NUM_TOP_STATIONS);
+}
+
+static const MenuHost s_dest_menu_host = {
+  .window = &s_app.windows.dest_menu_window,
+  .menu_layer = &s_app.menu_layers.dest_menu_layer,
+  .callbacks = {
     .get_num_sections = prv_dest_menu_get_num_sections_callback,
     .get_num_rows = prv_dest_menu_get_num_rows_callback,
     .draw_header = prv_dest_menu_draw_header_callback,
     .draw_row = prv_dest_menu_draw_row_callback,
     .select_click = prv_dest_menu_select_callback,
+    .selection_changed = prv_dest_menu_selection_changed_callback,
+  },
+  .heap_scope = HEAP_SCOPE_DEST_MENU,
+};
+
+static void prv_push_dest_menu(void) {
+  menu_host_push(&s_dest_menu_host);
+  prv_hint_destination_rows(prv_top_station_at, 0, NUM_TOP_STATIONS);
+}
+
+// Index of the first trip that has not departed yet, or -1 if all have left
+static int prv_first_upcoming_trip_index(void) {
+  return trip_format_first_upcoming(&s_app.trips, time(NULL));
+}
+
+// Name of a station in all_stations, or the code itself if it is not listed
+static const char *prv_station_name_for_code(const char *code) {
+  const int index = station_index_for_code(code);
+  return (index >= 0) ? station_name(&all_stations[index]) : code;
+}
+
+static void prv_handle_station_list(const uint8_t *data, uint16_t length) {
+  if (!protocol_decode_station_list(data, length, &s_app.stations)) { return; }
+  s_app.stations.loaded = true;
+  if (s_app.state.fallback_timer) { app_timer_cancel(s_app.state.fallback_timer); s_app.state.fallback_timer = NULL; }
+
+  // The phone is reachable now, so refresh a route that was opened from the cache
+  if (s_app.state.refresh_pending) {
+    s_app.state.refresh_pending = false;
+    prv_send_trip_request();
+  }
+
+  if (s_app.menu_layers.menu_layer) { menu_layer_reload_data(s_app.menu_layers.menu_layer); }
+
+  // Don't cover a countdown that was opened from the cache
+  if (window_stack_get_top_window() != s_app.windows.main_window) { return; }
+
+  menu_host_push(&s_station_menu_host);
+  trace_mark(TRACE_STATION_MENU);
+}
+
+// Whether the top window is one a route is picked from, so trips for it may
+// open the countdown over it
+static bool prv_picking_route(void) {
+  const Window *top = window_stack_get_top_window();
+  return top && (top == s_app.windows.main_window || top == s_app.windows.dest_menu_window ||
+                 top == s_app.windows.alpha_menu_window || top == s_app.windows.search_results_window);
+}
+
+static void prv_show_countdown_window(void) {
+  if (s_app.windows.countdown_window && window_stack_get_top_window() == s_app.windows.countdown_window) {
+    // Already showing this route, swap the new data in without reopening
+    s_app.journey.selected_trip_index = prv_first_upcoming_trip_index();
+    if (s_app.journey.selected_trip_index < 0) { s_app.journey.selected_trip_index = 0; }
+    prv_send_selected_trip(s_app.journey.selected_trip_index);
+    prv_stop_trip_card_animation();
+    prv_prepare_trip_cards();
+    return;
+  }
+  // Don't cover a reminder, or a list the user has gone back to
+  if (s_app.windows.countdown_window || !prv_picking_route()) { return; }
+  s_app.windows.countdown_window = window_create();
+  window_set_window_handlers(s_app.windows.countdown_window, (WindowHandlers) {
+    .load = prv_countdown_window_load, .unload = prv_countdown_window_unload,
   });
-  #ifdef PBL_COLOR
-  menu_layer_set_normal_colors(s_app.menu_layers.dest_menu_layer, GColorYellow, GColorBlack);
-  menu_layer_set_highlight_colors(s_app.menu_layers.dest_menu_layer, GColorOxfordBlue, GColorWhite);
-  #endif
-  layer_add_child(window_layer, menu_layer_get_layer(s_app.menu_layers.dest_menu_layer));
+  window_set_click_config_provider(s_app.windows.countdown_window, prv_countdown_click_config_provider);
+  window_stack_push(s_app.windows.countdown_window, true);
+  trace_mark(TRACE_COUNTDOWN);
 }
 
-static void prv_dest_menu_window_unload(Window *window) { menu_layer_destroy(s_app.menu_layers.dest_menu_layer); }
+static void prv_handle_trip_data(const uint8_t *data, uint16_t length) {
+  if (!protocol_decode_trip_data(data, length, &s_app.trips)) { return; }
+  s_app.trips.loaded = true;
+  s_app.trips.stale = false;
+  s_app.trips.scheduled = false;
+  s_app.state.awaiting_trips = false;
+  trace_mark(TRACE_TRIPS_RECEIVED);
+  trip_cache_store(s_app.journey.start_station_code, s_app.journey.dest_station_code, data, length);
+  const bool tracked_changed = tracking_update(&s_app.journey, &s_app.trips);
+  if (s_app.windows.reminder_window) {
+    prv_refresh_reminder();
+  } else if (tracked_changed) {
+    vibes_short_pulse();
+  }
+  prv_show_countdown_window();
+}
+
+// Open the countdown for the selected route from the cache, if it has trips
+// that have not left yet. The caller still requests fresh data.
+static bool prv_show_cached_trips(void) {
+  uint8_t payload[ROUTE_CACHE_PAYLOAD_SIZE];
+  time_t saved_at = 0;
+  int length = trip_cache_load(s_app.journey.start_station_code, s_app.journey.dest_station_code,
+                               payload, sizeof(payload), &saved_at);
+  if (length <= 0 || !protocol_decode_trip_data(payload, length, &s_app.trips)) { return false; }
+
+  if (prv_first_upcoming_trip_index() < 0) {
+    s_app.trips.count = 0;
+    return false;
+  }
+  APP_LOG(APP_LOG_LEVEL_INFO, "Showing trips cached %d s ago", (int)(time(NULL) - saved_at));
+  s_app.trips.loaded = true;
+  s_app.trips.stale = true;
+  s_app.trips.scheduled = false;
+  trip_cache_touch(s_app.journey.start_station_code, s_app.journey.dest_station_code);
+  prv_show_countdown_window();
+  return true;
+}
+
+// Open the countdown for the selected route from the offline timetable, for
+// when no live data can be had
+static bool prv_show_scheduled_trips(void) {
+  const int from = station_index_for_code(s_app.journey.start_station_code);
+  const int to = station_index_for_code(s_app.journey.dest_station_code);
+  if (from < 0 || to < 0 || !timetable_fill_trips(from, to, time(NULL), &s_app.trips)) { return false; }
+
+  s_app.trips.loaded = true;
+  s_app.trips.stale = false;
+  s_app.trips.scheduled = true;
+  s_app.state.awaiting_trips = false;
+  prv_show_countdown_window();
+  return true;
+}
+
+// Show whatever is cached for the selected route straight away and ask the
+// phone for fresh trips, which replace the cached ones when they arrive.
+// Without a cached copy and without the phone, fall back to the timetable.
+static void prv_select_route(void) {
+  prv_send_trip_request();
+  if (prv_show_cached_trips()) { return; }
+
+  s_app.state.awaiting_trips = true;
+  if (!connection_service_peek_pebble_app_connection()) {
+    prv_show_scheduled_trips();
+  }
+}
+
+// Reopen the last viewed route from the cache on launch. The refresh is sent
+// once the phone has answered, see prv_handle_station_list.
+static void prv_restore_last_route(void) {
+  char start_code[MAX_STATION_CODE_LENGTH];
+  char dest_code[MAX_STATION_CODE_LENGTH];
+  if (!trip_cache_last_route(start_code, dest_code)) { return; }
+
+  strncpy(s_app.journey.start_station_code, start_code, sizeof(s_app.journey.start_station_code) - 1);
+  strncpy(s_app.journey.dest_station_code, dest_code, sizeof(s_app.journey.dest_station_code) - 1);
+  strncpy(s_app.journey.start_station_name, prv_station_name_for_code(start_code), sizeof(s_app.journey.start_station_name) - 1);
+  strncpy(s_app.journey.dest_station_name, prv_station_name_for_code(dest_code), sizeof(s_app.journey.dest_station_name) - 1);
+  s_app.state.refresh_pending = prv_show_cached_trips();
+}
+
+// Patch one trip in place from a TRIP_DELTA byte array. Only the layers that
+// show a changed field are touched.
+static void prv_handle_trip_delta(const uint8_t *data, uint16_t length) {
+  int index;
+  uint8_t mask = protocol_apply_trip_delta(data, length, &s_app.trips, &index);
+  if (!mask) { return; }
+  if (tracking_update(&s_app.journey, &s_app.trips) && !s_app.windows.reminder_window) {
+    vibes_short_pulse();
+  }
+
+  if (!s_app.windows.countdown_window || !window_stack_contains_window(s_app.windows.countdown_window)) { return; }
+
+  // Patch every card showing this trip, including prepared neighbours
+  for (int i = 0; i < TRIP_CARD_COUNT; i++) {
+    TripCard *card = &s_app.countdown_ui.cards[i];
+    if (card->trip_index == index) {
+      prv_fill_trip_card(card, index, mask);
+    }
+  }
+  if (index == s_app.journey.selected_trip_index && (mask & (TRIP_DELTA_DEPARTURE | TRIP_DELTA_FLAGS))) {
+    prv_update_countdown(time(NULL));
+  }
+}
+
+// Route a complete payload, whether it arrived in one message or in chunks.
+// Every decoded payload passes here, so this is where the heap is sampled.
+static void prv_handle_payload(uint32_t key, const uint8_t *data, uint16_t length) {
+  if (key == MESSAGE_KEY_STATION_LIST) {
+    prv_handle_station_list(data, length);
+  } else if (key == MESSAGE_KEY_TRIP_DATA) {
+    prv_handle_trip_data(data, length);
+  } else if (key == MESSAGE_KEY_TRIP_DELTA) {
+    prv_handle_trip_delta(data, length);
+  } else if (key == MESSAGE_KEY_TIMETABLE) {
+    timetable_store(data, length);
+  } else {
+    APP_LOG(APP_LOG_LEVEL_WARNING, "Unknown payload key: %d", (int)key);
+  }
+  heap_debug_message_decoded(key, length);
+}
+
+// Store one chunk of a chunked transfer and dispatch the payload once every
+// chunk has arrived. Chunks may arrive in any order and may be retransmitted.
+static void prv_handle_chunk(DictionaryIterator *iter, Tuple *chunk_data_tuple) {
+  Tuple *chunk_key_tuple = dict_find(iter, MESSAGE_KEY_CHUNK_KEY);
+  Tuple *chunk_seq_tuple = dict_find(iter, MESSAGE_KEY_CHUNK_SEQ);
+  Tuple *chunk_count_tuple = dict_find(iter, MESSAGE_KEY_CHUNK_COUNT);
+  Tuple *chunk_length_tuple = dict_find(iter, MESSAGE_KEY_CHUNK_LENGTH);
+  if (!chunk_key_tuple || !chunk_seq_tuple || !chunk_count_tuple || !chunk_length_tuple) { return; }
+
+  uint32_t key = chunk_key_tuple->value->uint32;
+  int seq = chunk_seq_tuple->value->int32;
+  int count = chunk_count_tuple->value->int32;
+  int length = chunk_length_tuple->value->int32;
+  int chunk_length = chunk_data_tuple->length;
+  if (count <= 0 || count > MAX_CHUNKS || seq < 0 || seq >= count || length > MAX_CHUNKED_PAYLOAD_LENGTH) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Rejected chunk %d/%d of %d bytes", seq, count, length);
+    return;
+  }
+
+  ChunkTransfer *transfer = &s_app.transfer;
+  if (transfer->key != key || transfer->length != length || transfer->chunk_count != count) {
+    // A new payload supersedes whatever was being reassembled
+    transfer->key = key;
+    transfer->length = length;
+    transfer->chunk_count = count;
+    transfer->received_mask = 0;
+  }
+
+  int offset = (seq == count - 1) ? length - chunk_length : seq * chunk_length;
+  if (offset < 0 || offset + chunk_length > length) { return; }
+  memcpy(&transfer->buffer[offset], chunk_data_tuple->value->data, chunk_length);
+  transfer->received_mask |= (1u << seq);
+
+  uint32_t complete_mask = (count == 32) ? 0xFFFFFFFFu : ((1u << count) - 1);
+  if (transfer->received_mask == complete_mask) {
+    transfer->key = 0;
+    transfer->received_mask = 0;
+    prv_handle_payload(key, transfer->buffer, length);
+  }
+}
+
+static const char *prv_error_message(int32_t code) {
+  switch (code) {
+    case ERROR_AUTH: return "Add API key in settings...";
+    case ERROR_NETWORK: return "No connection, try again later";
+    case ERROR_RATE_LIMITED: return "Too many requests, wait a minute";
+    case ERROR_NO_RESULTS: return "Nothing found";
+    case ERROR_LOCATION: return "Location unavailable";
+    default: return "NS service unavailable";
+  }
+}
 
 static void prv_inbox_received_handler(DictionaryIterator *iter, void *context) {
-  Tuple *station_index_tuple = dict_find(iter, MESSAGE_KEY_STATION_INDEX);
-  Tuple *station_name_tuple = dict_find(iter, MESSAGE_KEY_STATION_NAME);
-  Tuple *station_code_tuple = dict_find(iter, MESSAGE_KEY_STATION_CODE);
-  Tuple *station_count_tuple = dict_find(iter, MESSAGE_KEY_STATION_COUNT);
-  Tuple *trip_index_tuple = dict_find(iter, MESSAGE_KEY_TRIP_INDEX);
-  Tuple *trip_planned_departure_time_tuple = dict_find(iter, MESSAGE_KEY_TRIP_PLANNED_DEPARTURE_TIME);
-  Tuple *trip_departure_time_epoch_tuple = dict_find(iter, MESSAGE_KEY_TRIP_DEPARTURE_TIME_EPOCH);
-  Tuple *trip_planned_arrival_time_tuple = dict_find(iter, MESSAGE_KEY_TRIP_PLANNED_ARRIVAL_TIME);
-  Tuple *trip_arrival_time_tuple = dict_find(iter, MESSAGE_KEY_TRIP_ARRIVAL_TIME);
-  Tuple *trip_transfers_tuple = dict_find(iter, MESSAGE_KEY_TRIP_TRANSFERS);
-  Tuple *trip_platform_tuple = dict_find(iter, MESSAGE_KEY_TRIP_PLATFORM);
-  Tuple *trip_count_tuple = dict_find(iter, MESSAGE_KEY_TRIP_COUNT);
-  Tuple *trip_delay_tuple = dict_find(iter, MESSAGE_KEY_TRIP_DELAY);
+  Tuple *chunk_data_tuple = dict_find(iter, MESSAGE_KEY_CHUNK_DATA);
   Tuple *error_tuple = dict_find(iter, MESSAGE_KEY_ERROR);
-  
+  Tuple *reminder_lead_tuple = dict_find(iter, MESSAGE_KEY_REMINDER_LEAD);
+
+  if (reminder_lead_tuple) {
+    reminder_set_lead_minutes(reminder_lead_tuple->value->int32);
+  }
+
   if (error_tuple) {
-    text_layer_set_text(s_app.main_ui.text_layer, "Add API key in settings...");
+    const int32_t code = error_tuple->value->int32;
+    // A reminder keeps showing the departure it was scheduled with
+    if (s_app.windows.reminder_window) { return; }
+    // Live trips could not be fetched, the timetable is better than nothing
+    if (s_app.state.awaiting_trips && code != ERROR_AUTH && code != ERROR_NO_RESULTS) {
+      s_app.state.awaiting_trips = false;
+      if (prv_show_scheduled_trips()) { return; }
+    }
+    text_layer_set_text(s_app.main_ui.text_layer, prv_error_message(code));
     return;
   }
 
-  if (station_index_tuple && station_name_tuple && station_count_tuple && station_code_tuple) {
-    int index = station_index_tuple->value->int32;
-    const char *name = station_name_tuple->value->cstring;
-    const char *code = station_code_tuple->value->cstring;
-    int count = station_count_tuple->value->int32;
-    if (index >= 0 && index < MAX_STATIONS) {
-      strncpy(s_app.stations.names[index], name, MAX_STATION_NAME_LENGTH - 1);
-      s_app.stations.names[index][MAX_STATION_NAME_LENGTH - 1] = '\0';
-      strncpy(s_app.stations.codes[index], code, MAX_STATION_CODE_LENGTH - 1);
-      s_app.stations.codes[index][MAX_STATION_CODE_LENGTH-1] = '\0';
-      if (index + 1 > s_app.stations.count) { s_app.stations.count = index + 1; }
-      if (s_app.stations.count >= count) {
-        s_app.stations.loaded = true;
-        if (s_app.state.fallback_timer) { app_timer_cancel(s_app.state.fallback_timer); s_app.state.fallback_timer = NULL; }
-
-        if (s_app.menu_layers.menu_layer) { menu_layer_reload_data(s_app.menu_layers.menu_layer); }
-
-        if (!s_app.windows.menu_window) {
-          s_app.windows.menu_window = window_create();
-          window_set_window_handlers(s_app.windows.menu_window, (WindowHandlers) { .load = prv_menu_window_load, .unload = prv_menu_window_unload, });
-        }
-        window_stack_push(s_app.windows.menu_window, true);
-      }
-    }
+  if (chunk_data_tuple && chunk_data_tuple->type == TUPLE_BYTE_ARRAY) {
+    prv_handle_chunk(iter, chunk_data_tuple);
   }
 
-  if (trip_index_tuple && trip_departure_time_epoch_tuple && trip_arrival_time_tuple && trip_transfers_tuple && trip_count_tuple && trip_platform_tuple && trip_delay_tuple && trip_planned_departure_time_tuple && trip_planned_arrival_time_tuple) {
-    int index = trip_index_tuple->value->int32;
-    const char *planned_departure_time = trip_planned_departure_time_tuple->value->cstring;
-    int departure_time = trip_departure_time_epoch_tuple->value->int32;
-    const char *planned_arrival_time = trip_planned_arrival_time_tuple->value->cstring;
-    const char *arrival_time = trip_arrival_time_tuple->value->cstring;
-    int count = trip_count_tuple->value->int32;
-    int transfers_val = trip_transfers_tuple->value->int32;
-    const char *platform = trip_platform_tuple->value->cstring;
-    const char *delay = trip_delay_tuple->value->cstring;
-
-    if (index >= 0 && index < MAX_TRIPS) {
-      strncpy(s_app.trips.planned_departures[index], planned_departure_time, MAX_DATE_TIME_LENGTH - 1);
-      s_app.trips.planned_departures[index][MAX_DATE_TIME_LENGTH - 1] = '\0';
-      s_app.trips.departures[index] = departure_time;
-
-      strncpy(s_app.trips.planned_arrivals[index], planned_arrival_time, MAX_DATE_TIME_LENGTH - 1);
-      s_app.trips.planned_arrivals[index][MAX_DATE_TIME_LENGTH - 1] = '\0';
-      strncpy(s_app.trips.arrivals[index], arrival_time, MAX_DATE_TIME_LENGTH - 1);
-      s_app.trips.arrivals[index][MAX_DATE_TIME_LENGTH - 1] = '\0';
-
-      snprintf(s_app.trips.transfers[index], MAX_TRANSFERS_LENGTH, "%d", transfers_val);
-      strncpy(s_app.trips.platform[index], platform, MAX_PLATFORM_LENGTH - 1);
-      s_app.trips.platform[index][MAX_PLATFORM_LENGTH - 1] = '\0';
-
-      strncpy(s_app.trips.delay[index], delay, MAX_DELAY_LENGTH - 1);
-      s_app.trips.delay[index][MAX_DELAY_LENGTH - 1] = '\0';
-
-      if (index + 1 > s_app.trips.count) { s_app.trips.count = index + 1; }
-      if (s_app.trips.count >= count) {
-        s_app.trips.loaded = true;
-        if (!s_app.windows.countdown_window) {
-          s_app.windows.countdown_window = window_create();
-          window_set_window_handlers(s_app.windows.countdown_window, (WindowHandlers) {
-            .load = prv_countdown_window_load, .unload = prv_countdown_window_unload,
-          });
-          window_set_click_config_provider(s_app.windows.countdown_window, prv_countdown_click_config_provider);
-        }
-        window_stack_push(s_app.windows.countdown_window, true);
-      }
+  // Payloads that fit in one message take the same route as chunked ones
+  const uint32_t payload_keys[] = {
+    MESSAGE_KEY_STATION_LIST, MESSAGE_KEY_TRIP_DATA, MESSAGE_KEY_TRIP_DELTA, MESSAGE_KEY_TIMETABLE,
+  };
+  for (size_t i = 0; i < ARRAY_LENGTH(payload_keys); i++) {
+    Tuple *tuple = dict_find(iter, payload_keys[i]);
+    if (tuple && tuple->type == TUPLE_BYTE_ARRAY) {
+      prv_handle_payload(payload_keys[i], tuple->value->data, tuple->length);
     }
   }
 }
 
 static void prv_inbox_dropped_handler(AppMessageResult reason, void *context) { APP_LOG(APP_LOG_LEVEL_ERROR, "Message dropped: %d", (int)reason); }
-static void prv_outbox_failed_handler(DictionaryIterator *iter, AppMessageResult reason, void *context) { APP_LOG(APP_LOG_LEVEL_ERROR, "Outbox send failed: %d", (int)reason); }
-static void prv_outbox_sent_handler(DictionaryIterator *iter, void *context) { APP_LOG(APP_LOG_LEVEL_INFO, "Outbox send success"); }
+static void prv_outbox_failed_handler(DictionaryIterator *iter, AppMessageResult reason, void *context) { APP_LOG(APP_LOG_LEVEL_ERROR, "Outbox send failed: %d", (int)reason); prv_flush_pending_messages(); }
+static void prv_outbox_sent_handler(DictionaryIterator *iter, void *context) { APP_LOG(APP_LOG_LEVEL_INFO, "Outbox send success"); prv_flush_pending_messages(); }
 
 static void prv_request_stations_from_phone(void) {
   DictionaryIterator *iter;
   if (app_message_outbox_begin(&iter) == APP_MSG_OK) {
     dict_write_uint8(iter, MESSAGE_KEY_REQUEST_STATIONS, 1);
+    dict_write_uint32(iter, MESSAGE_KEY_INBOX_SIZE, s_app.state.inbox_size);
     if (app_message_outbox_send() == APP_MSG_OK) {
+      trace_mark(TRACE_STATIONS_REQUESTED);
       text_layer_set_text(s_app.main_ui.text_layer, "Fetching nearby stations...");
     }
   }
 }
 
+// --- Reminder Window ---
+// Opened instead of the main window when a reminder wakes the app. It shows
+// the departure as known when the reminder was set and asks the phone for a
+// fresh one if it is around.
+
+static const uint32_t s_reminder_vibe_segments[] = { 300, 150, 300, 150, 600 };
+
+static const char *prv_reminder_title(const Reminder *reminder, time_t now) {
+  if (reminder->flags & TRIP_FLAG_CANCELLED) { return "Cancelled"; }
+  // Woken early because the trip changed, not because it is time to go
+  if (reminder->departure - now > (reminder_lead_minutes() + 1) * 60) { return "Trip changed"; }
+  return "Leave now";
+}
+
+static void prv_vibe_reminder(void) {
+  vibes_enqueue_custom_pattern((VibePattern) {
+    .durations = s_reminder_vibe_segments, .num_segments = ARRAY_LENGTH(s_reminder_vibe_segments),
+  });
+}
+
+static void prv_update_reminder_text(void) {
+  const Reminder *reminder = &s_app.reminder;
+  text_layer_set_text(s_app.reminder_ui.title_layer, prv_reminder_title(reminder, time(NULL)));
+  char time_text[6];
+  char status_text[16] = "";
+  trip_format_clock_time(reminder->departure, time_text, sizeof(time_text));
+  if (reminder->flags & TRIP_FLAG_CANCELLED) {
+    snprintf(status_text, sizeof(status_text), "\nCancelled");
+  } else if (reminder->delay > 0) {
+    snprintf(status_text, sizeof(status_text), "\n+%d min", reminder->delay);
+  }
+  snprintf(s_app.reminder_ui.detail_buffer, sizeof(s_app.reminder_ui.detail_buffer), "%s to %s\nPlatform %s%s",
+           time_text, reminder->dest_name, reminder->platform[0] ? reminder->platform : "-", status_text);
+  text_layer_set_text(s_app.reminder_ui.detail_layer, s_app.reminder_ui.detail_buffer);
+}
+
+// Take the reminded trip from fresh TRIP_DATA, buzzing once more if it changed
+static void prv_refresh_reminder(void) {
+  Reminder *reminder = &s_app.reminder;
+  for (int i = 0; i < s_app.trips.count; i++) {
+    if (s_app.trips.planned_departures[i] != reminder->planned_departure) { continue; }
+
+    const bool changed = reminder->departure != s_app.trips.departures[i] || reminder->flags != s_app.trips.flags[i] ||
+                         strncmp(reminder->platform, s_app.trips.platform[i], sizeof(reminder->platform)) != 0;
+    reminder->departure = s_app.trips.departures[i];
+    reminder->delay = s_app.trips.delays[i];
+    reminder->flags = s_app.trips.flags[i];
+    strncpy(reminder->platform, s_app.trips.platform[i], sizeof(reminder->platform) - 1);
+    prv_update_reminder_text();
+    if (changed) { vibes_short_pulse(); }
+    return;
+  }
+}
+
+static void prv_reminder_select_click_handler(ClickRecognizerRef recognizer, void *context) {
+  window_stack_pop(true);
+}
+
+static void prv_reminder_click_config_provider(void *context) {
+  window_single_click_subscribe(BUTTON_ID_SELECT, prv_reminder_select_click_handler);
+}
+
+static void prv_reminder_window_load(Window *window) {
+  heap_debug_window_loading(HEAP_SCOPE_REMINDER);
+  Layer *window_layer = window_get_root_layer(window);
+  GRect bounds = layer_get_bounds(window_layer);
+  const int inset = PBL_IF_ROUND_ELSE(18, 4);
+  const int top = PBL_IF_ROUND_ELSE(30, 12);
+
+  s_app.reminder_ui.title_layer = text_layer_create(GRect(inset, top, bounds.size.w - inset * 2, 34));
+  text_layer_set_font(s_app.reminder_ui.title_layer, fonts_get_system_font(FONT_KEY_GOTHIC_28_BOLD));
+  text_layer_set_text_alignment(s_app.reminder_ui.title_layer, PBL_IF_ROUND_ELSE(GTextAlignmentCenter, GTextAlignmentLeft));
+  layer_add_child(window_layer, text_layer_get_layer(s_app.reminder_ui.title_layer));
+
+  s_app.reminder_ui.detail_layer = text_layer_create(GRect(inset, top + 38, bounds.size.w - inset * 2, bounds.size.h - top - 38));
+  text_layer_set_font(s_app.reminder_ui.detail_layer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
+  text_layer_set_text_alignment(s_app.reminder_ui.detail_layer, PBL_IF_ROUND_ELSE(GTextAlignmentCenter, GTextAlignmentLeft));
+  text_layer_set_overflow_mode(s_app.reminder_ui.detail_layer, GTextOverflowModeWordWrap);
+  layer_add_child(window_layer, text_layer_get_layer(s_app.reminder_ui.detail_layer));
+  prv_update_reminder_text();
+
+  prv_vibe_reminder();
+  heap_debug_window_loaded(HEAP_SCOPE_REMINDER);
+}
+
+static void prv_reminder_window_unload(Window *window) {
+  text_layer_destroy(s_app.reminder_ui.title_layer);
+  text_layer_destroy(s_app.reminder_ui.detail_layer);
+  window_destroy(window);
+  s_app.windows.reminder_window = NULL;
+  heap_debug_window_unloaded(HEAP_SCOPE_REMINDER);
+}
+
+static void prv_push_reminder_window(void) {
+  s_app.windows.reminder_window = window_create();
+  window_set_window_handlers(s_app.windows.reminder_window, (WindowHandlers) {
+    .load = prv_reminder_window_load, .unload = prv_reminder_window_unload,
+  });
+  window_set_click_config_provider(s_app.windows.reminder_window, prv_reminder_click_config_provider);
+  window_stack_push(s_app.windows.reminder_window, false);
+}
+
+// Launched for a reminder: open it alone and ask for its route's trips
+static void prv_launch_reminder(void) {
+  strncpy(s_app.journey.start_station_code, s_app.reminder.start_code, sizeof(s_app.journey.start_station_code) - 1);
+  strncpy(s_app.journey.dest_station_code, s_app.reminder.dest_code, sizeof(s_app.journey.dest_station_code) - 1);
+  strncpy(s_app.journey.dest_station_name, s_app.reminder.dest_name, sizeof(s_app.journey.dest_station_name) - 1);
+  prv_push_reminder_window();
+  if (connection_service_peek_pebble_app_connection()) {
+    prv_send_trip_request();
+  }
+}
+
+// The worker alerts while the app is open. A reminder or the countdown for
+// the tracked trip already shows it, so those only buzz; anything else gets
+// the reminder on top.
+static void prv_worker_message_handler(uint16_t type, AppWorkerMessage *message) {
+  if (type != TRACKING_MSG_ALERT || !tracking_load(&s_app.reminder)) { return; }
+  if (s_app.windows.reminder_window) {
+    prv_update_reminder_text();
+    prv_vibe_reminder();
+    return;
+  }
+  if (s_app.windows.countdown_window && window_stack_get_top_window() == s_app.windows.countdown_window &&
+      strncmp(s_app.reminder.start_code, s_app.journey.start_station_code, sizeof(s_app.reminder.start_code)) == 0 &&
+      strncmp(s_app.reminder.dest_code, s_app.journey.dest_station_code, sizeof(s_app.reminder.dest_code)) == 0) {
+    prv_vibe_reminder();
+    return;
+  }
+  prv_push_reminder_window();
+}
+
 static void prv_select_click_handler(ClickRecognizerRef recognizer, void *context) {
   if (!s_app.stations.loaded) { return; }
-  if (!s_app.windows.menu_window) {
-    s_app.windows.menu_window = window_create();
-    window_set_window_handlers(s_app.windows.menu_window, (WindowHandlers) { .load = prv_menu_window_load, .unload = prv_menu_window_unload, });
-  }
-  window_stack_push(s_app.windows.menu_window, true);
+  menu_host_push(&s_station_menu_host);
 }
 
 static void prv_up_click_handler(ClickRecognizerRef recognizer, void *context) {
@@ -616,6 +1199,7 @@ static void prv_click_config_provider(void *context) {
 }
 
 static void prv_window_load(Window *window) {
+  heap_debug_window_loading(HEAP_SCOPE_MAIN);
   Layer *window_layer = window_get_root_layer(window);
   GRect bounds = layer_get_bounds(window_layer);
   const int bar_height = 40;
@@ -647,6 +1231,8 @@ static void prv_window_load(Window *window) {
   layer_add_child(window_layer, text_layer_get_layer(s_app.main_ui.text_layer));
 
   prv_request_stations_from_phone();
+
+  heap_debug_window_loaded(HEAP_SCOPE_MAIN);
 }
 
 static void prv_window_unload(Window *window) {
@@ -656,11 +1242,14 @@ static void prv_window_unload(Window *window) {
   #ifdef PBL_COLOR
     layer_destroy(s_app.main_ui.bg_yellow_layer);
   #endif
+  heap_debug_window_unloaded(HEAP_SCOPE_MAIN);
 }
 
 static void prv_init(void) {
   // Initialize all app data to zero
   memset(&s_app, 0, sizeof(AppData));
+  trace_mark(TRACE_APP_START);
+  heap_debug_init();
   s_app.buffers.letter_str[0] = 'A';
   s_app.buffers.letter_str[1] = '\0';
 
@@ -668,29 +1257,138 @@ static void prv_init(void) {
   app_message_register_inbox_dropped(prv_inbox_dropped_handler);
   app_message_register_outbox_failed(prv_outbox_failed_handler);
   app_message_register_outbox_sent(prv_outbox_sent_handler);
-  app_message_open(256, 256);
+  s_app.state.inbox_size = app_message_inbox_size_maximum();
+  if (s_app.state.inbox_size > APP_MESSAGE_INBOX_BUDGET) {
+    s_app.state.inbox_size = APP_MESSAGE_INBOX_BUDGET;
+  }
+  app_message_open(s_app.state.inbox_size, APP_MESSAGE_OUTBOX_SIZE);
+  app_worker_message_subscribe(prv_worker_message_handler);
+  if (reminder_take_launch(&s_app.reminder) ||
+      (launch_reason() == APP_LAUNCH_WORKER && tracking_load(&s_app.reminder))) {
+    prv_launch_reminder();
+    return;
+  }
+  tracking_tidy(time(NULL));
   s_app.windows.main_window = window_create();
   window_set_click_config_provider(s_app.windows.main_window, prv_click_config_provider);
   window_set_window_handlers(s_app.windows.main_window, (WindowHandlers) { .load = prv_window_load, .unload = prv_window_unload, });
   window_stack_push(s_app.windows.main_window, true);
   s_app.state.fallback_timer = app_timer_register(10000, prv_fallback_timer_callback, NULL);
+  prv_restore_last_route();
 }
 
 static void prv_deinit(void) {
+  heap_debug_report();
+  // Timetable trips are guesses, don't put them in the launcher
+  if (s_app.trips.loaded && !s_app.trips.scheduled) {
+    glance_publish(&s_app.journey, &s_app.trips, time(NULL));
+  }
   if(s_app.state.fallback_timer) app_timer_cancel(s_app.state.fallback_timer);
-  if(s_app.windows.menu_window) window_destroy(s_app.windows.menu_window);
-  if(s_app.windows.dest_menu_window) window_destroy(s_app.windows.dest_menu_window);
-  if(s_app.windows.alpha_menu_window) window_destroy(s_app.windows.alpha_menu_window);
-  if(s_app.windows.countdown_window) window_destroy(s_app.windows.countdown_window);
-  window_destroy(s_app.windows.main_window);
+  prv_cancel_prefetch_hint();
+  app_worker_message_unsubscribe();
+  // Every window but the main one destroys itself when it is unloaded
+  window_stack_pop_all(false);
+  if (s_app.windows.main_window) { window_destroy(s_app.windows.main_window); }
 }
 
+// Request trips for the selected route. A prefetch hint may still be on its
+// way, so a busy outbox sends the request once the hint has gone out.
 static void prv_send_trip_request(void) {
+  prv_cancel_prefetch_hint();
+
   DictionaryIterator *iter;
   if (app_message_outbox_begin(&iter) == APP_MSG_OK) {
     dict_write_cstring(iter, MESSAGE_KEY_START_STATION_CODE, s_app.journey.start_station_code);
     dict_write_cstring(iter, MESSAGE_KEY_DEST_STATION_CODE, s_app.journey.dest_station_code);
-    app_message_outbox_send();
+    if (app_message_outbox_send() == APP_MSG_OK) {
+      trace_mark(TRACE_TRIP_REQUESTED);
+      s_app.state.trip_request_pending = false;
+      return;
+    }
+  }
+  s_app.state.trip_request_pending = true;
+}
+
+// Tell the phone which trip to keep live-updating, or -1 to stop. If the
+// outbox is busy the index is sent once the current message has gone out.
+static void prv_send_selected_trip(int index) {
+  DictionaryIterator *iter;
+  if (app_message_outbox_begin(&iter) == APP_MSG_OK) {
+    dict_write_int32(iter, MESSAGE_KEY_TRIP_SELECTED, index);
+    if (app_message_outbox_send() == APP_MSG_OK) {
+      s_app.state.selected_trip_pending = false;
+      return;
+    }
+  }
+  s_app.state.pending_selected_trip = index;
+  s_app.state.selected_trip_pending = true;
+}
+
+// --- Prefetch Hints ---
+// While a destination list is open the phone is told which stations are
+// around the highlighted row (see "Prefetch Hint Protocol" in trein_data.h).
+// Scrolling restarts a short timer, so only the row the user stops on is sent.
+
+static void prv_send_prefetch_hint(void) {
+  PrefetchHint *hint = &s_app.prefetch;
+  uint8_t bytes[PREFETCH_HINT_HEADER_SIZE + PREFETCH_HINT_MAX_STATIONS * 2];
+  bytes[0] = PREFETCH_HINT_VERSION;
+  bytes[1] = hint->count;
+  for (int i = 0; i < hint->count; i++) {
+    bytes[PREFETCH_HINT_HEADER_SIZE + i * 2] = hint->stations[i] & 0xFF;
+    bytes[PREFETCH_HINT_HEADER_SIZE + i * 2 + 1] = hint->stations[i] >> 8;
+  }
+
+  DictionaryIterator *iter;
+  if (app_message_outbox_begin(&iter) == APP_MSG_OK) {
+    dict_write_cstring(iter, MESSAGE_KEY_START_STATION_CODE, s_app.journey.start_station_code);
+    dict_write_data(iter, MESSAGE_KEY_PREFETCH_HINT, bytes, PREFETCH_HINT_HEADER_SIZE + hint->count * 2);
+    if (app_message_outbox_send() == APP_MSG_OK) {
+      hint->pending = false;
+      return;
+    }
+  }
+  hint->pending = true;
+}
+
+static void prv_prefetch_hint_timer_callback(void *context) {
+  s_app.prefetch.timer = NULL;
+  prv_send_prefetch_hint();
+}
+
+static void prv_cancel_prefetch_hint(void) {
+  if (s_app.prefetch.timer) {
+    app_timer_cancel(s_app.prefetch.timer);
+    s_app.prefetch.timer = NULL;
+  }
+  s_app.prefetch.pending = false;
+}
+
+// Hint the station on `row` of a destination list and its neighbours.
+// `station_at` maps a row of that list to an all_stations index.
+static void prv_hint_destination_rows(int (*station_at)(int row), int row, int row_count) {
+  PrefetchHint *hint = &s_app.prefetch;
+  if (row_count <= 0 || s_app.journey.start_station_code[0] == '\0') { return; }
+
+  hint->count = 0;
+  hint->stations[hint->count++] = station_at(row);
+  if (row > 0) { hint->stations[hint->count++] = station_at(row - 1); }
+  if (row + 1 < row_count) { hint->stations[hint->count++] = station_at(row + 1); }
+
+  if (hint->timer) {
+    app_timer_reschedule(hint->timer, PREFETCH_HINT_DELAY_MS);
+  } else {
+    hint->timer = app_timer_register(PREFETCH_HINT_DELAY_MS, prv_prefetch_hint_timer_callback, NULL);
+  }
+}
+
+static void prv_flush_pending_messages(void) {
+  if (s_app.state.trip_request_pending) {
+    prv_send_trip_request();
+  } else if (s_app.state.selected_trip_pending) {
+    prv_send_selected_trip(s_app.state.pending_selected_trip);
+  } else if (s_app.prefetch.pending) {
+    prv_send_prefetch_hint();
   }
 }
 
@@ -698,57 +1396,42 @@ static void prv_countdown_select_click_handler(ClickRecognizerRef recognizer, vo
   window_stack_pop_all(true);
 }
 
+// Set a reminder for the trip on screen and exit, the wakeup brings the app
+// back when it is time to leave
+static void prv_countdown_long_select_click_handler(ClickRecognizerRef recognizer, void *context) {
+  if (!reminder_schedule(&s_app.journey, &s_app.trips, s_app.journey.selected_trip_index, time(NULL))) {
+    vibes_double_pulse();
+    return;
+  }
+  vibes_short_pulse();
+  window_stack_pop_all(true);
+}
+
+// Track the trip on screen in the background worker, or stop tracking it
+static void prv_countdown_long_down_click_handler(ClickRecognizerRef recognizer, void *context) {
+  const int index = s_app.journey.selected_trip_index;
+  if (tracking_is_tracked(&s_app.journey, s_app.trips.planned_departures[index])) {
+    tracking_stop();
+    vibes_long_pulse();
+  } else if (tracking_start(&s_app.journey, &s_app.trips, index, time(NULL))) {
+    vibes_short_pulse();
+  } else {
+    vibes_double_pulse();
+  }
+}
+
 static void prv_countdown_click_config_provider(void *context) {
   window_single_click_subscribe(BUTTON_ID_SELECT, prv_countdown_select_click_handler);
+  window_long_click_subscribe(BUTTON_ID_SELECT, 500, prv_countdown_long_select_click_handler, NULL);
   window_single_click_subscribe(BUTTON_ID_UP, prv_countdown_up_click_handler);
   window_single_click_subscribe(BUTTON_ID_DOWN, prv_countdown_down_click_handler);
+  window_long_click_subscribe(BUTTON_ID_DOWN, 500, prv_countdown_long_down_click_handler, NULL);
 }
 
- static void prv_countdown_window_load(Window *window) {
-  Layer *window_layer = window_get_root_layer(window);
-  GRect bounds = layer_get_bounds(window_layer);
+// Create the layers of one trip card. The card's container covers the whole
+// window, so the children keep their window coordinates.
+static void prv_create_trip_card(TripCard *card, Layer *window_layer, GRect bounds) {
   const int bar_height = 40;
-  s_app.journey.selected_trip_index = 0;
-
-  #ifdef PBL_COLOR
-    s_app.countdown_ui.bg_blue_layer = layer_create(GRect(0, 0, bounds.size.w, bar_height));
-    layer_set_update_proc(s_app.countdown_ui.bg_blue_layer, prv_bg_blue_update_proc);
-    layer_add_child(window_layer, s_app.countdown_ui.bg_blue_layer);
-    s_app.countdown_ui.bg_blue_bottom_layer = layer_create(GRect(0, bounds.size.h - bar_height, bounds.size.w, bar_height));
-    layer_set_update_proc(s_app.countdown_ui.bg_blue_bottom_layer, prv_bg_blue_update_proc);
-    layer_add_child(window_layer, s_app.countdown_ui.bg_blue_bottom_layer);
-    s_app.countdown_ui.bg_yellow_layer = layer_create(GRect(0, bar_height, bounds.size.w, bounds.size.h - (bar_height * 2)));
-    layer_set_update_proc(s_app.countdown_ui.bg_yellow_layer, prv_bg_yellow_update_proc);
-    layer_add_child(window_layer, s_app.countdown_ui.bg_yellow_layer);
-  #else
-    s_app.countdown_ui.bg_blue_layer = layer_create(GRect(0, 0, bounds.size.w, bar_height));
-    layer_set_update_proc(s_app.countdown_ui.bg_blue_layer, prv_bg_black_update_proc);
-    layer_add_child(window_layer, s_app.countdown_ui.bg_blue_layer);
-    s_app.countdown_ui.bg_blue_bottom_layer = layer_create(GRect(0, bounds.size.h - bar_height, bounds.size.w, bar_height));
-    layer_set_update_proc(s_app.countdown_ui.bg_blue_bottom_layer, prv_bg_black_update_proc);
-    layer_add_child(window_layer, s_app.countdown_ui.bg_blue_bottom_layer);
-  #endif
-
-  s_app.countdown_ui.trip_leg_layer = layer_create(bounds);
-  layer_set_update_proc(s_app.countdown_ui.trip_leg_layer, prv_trip_leg_layer_update_proc);
-  layer_add_child(window_layer, s_app.countdown_ui.trip_leg_layer);
-
-  s_app.countdown_ui.start_station_layer = text_layer_create(GRect(0, 10, bounds.size.w, 30));
-  text_layer_set_text(s_app.countdown_ui.start_station_layer, s_app.journey.start_station_name);
-  text_layer_set_font(s_app.countdown_ui.start_station_layer, fonts_get_system_font((bounds.size.w == 200) ? FONT_KEY_GOTHIC_28_BOLD : FONT_KEY_GOTHIC_24_BOLD));
-  text_layer_set_text_alignment(s_app.countdown_ui.start_station_layer, GTextAlignmentCenter);
-  text_layer_set_background_color(s_app.countdown_ui.start_station_layer, GColorClear);
-  text_layer_set_text_color(s_app.countdown_ui.start_station_layer, GColorWhite);
-  layer_add_child(window_layer, text_layer_get_layer(s_app.countdown_ui.start_station_layer));
-
-  s_app.countdown_ui.destination_layer = text_layer_create(GRect(0, bounds.size.h - bar_height, bounds.size.w, 30));
-  text_layer_set_text(s_app.countdown_ui.destination_layer, s_app.journey.dest_station_name);
-  text_layer_set_font(s_app.countdown_ui.destination_layer, fonts_get_system_font((bounds.size.w == 200) ? FONT_KEY_GOTHIC_28_BOLD : FONT_KEY_GOTHIC_24_BOLD));
-  text_layer_set_text_alignment(s_app.countdown_ui.destination_layer, GTextAlignmentCenter);
-  text_layer_set_background_color(s_app.countdown_ui.destination_layer, GColorClear);
-  text_layer_set_text_color(s_app.countdown_ui.destination_layer, GColorWhite);
-  layer_add_child(window_layer, text_layer_get_layer(s_app.countdown_ui.destination_layer));
-
   const int platform_y  = PBL_IF_ROUND_ELSE(40, 35);
   // Center the countdown in the middle of the screen (between top and bottom bars)
   const int content_height = bounds.size.h - (bar_height * 2); // Height between bars
@@ -765,58 +1448,110 @@ static void prv_countdown_click_config_provider(void *context) {
   const bool is_large_display = (bounds.size.w == 200);
   #endif
 
-  s_app.countdown_ui.departure_time_layer = text_layer_create(PBL_IF_ROUND_ELSE(GRect(17, platform_y + 4, 30, 20), GRect(x_offset, platform_y + 2, is_large_display ? 40 : 30, 20)));
-  text_layer_set_font(s_app.countdown_ui.departure_time_layer, fonts_get_system_font(is_large_display ? FONT_KEY_GOTHIC_18 : FONT_KEY_GOTHIC_14));
-  text_layer_set_text_alignment(s_app.countdown_ui.departure_time_layer, GTextAlignmentLeft);
-  text_layer_set_background_color(s_app.countdown_ui.departure_time_layer, GColorClear);
-  text_layer_set_text_color(s_app.countdown_ui.departure_time_layer, GColorBlack);
-  layer_add_child(window_layer, text_layer_get_layer(s_app.countdown_ui.departure_time_layer));
-
-  s_app.countdown_ui.time_arrow_layer = text_layer_create(PBL_IF_ROUND_ELSE(GRect(47, platform_y + 4, 15, 20), GRect(x_offset + (is_large_display ? 40 : 30), platform_y + 2, is_large_display ? 20 : 15, 20)));
-  text_layer_set_font(s_app.countdown_ui.time_arrow_layer, fonts_get_system_font(is_large_display ? FONT_KEY_GOTHIC_18 : FONT_KEY_GOTHIC_14));
-  text_layer_set_text_alignment(s_app.countdown_ui.time_arrow_layer, GTextAlignmentCenter);
-  text_layer_set_background_color(s_app.countdown_ui.time_arrow_layer, GColorClear);
-  text_layer_set_text_color(s_app.countdown_ui.time_arrow_layer, GColorBlack);
+  card->layer = layer_create(bounds);
+  layer_add_child(window_layer, card->layer);
+
+  card->trip_leg_layer = layer_create_with_data(bounds, sizeof(TripCard *));
+  *(TripCard **)layer_get_data(card->trip_leg_layer) = card;
+  layer_set_update_proc(card->trip_leg_layer, prv_trip_leg_layer_update_proc);
+  layer_add_child(card->layer, card->trip_leg_layer);
+
+  card->departure_time_layer = text_layer_create(PBL_IF_ROUND_ELSE(GRect(17, platform_y + 4, 30, 20), GRect(x_offset, platform_y + 2, is_large_display ? 40 : 30, 20)));
+  text_layer_set_font(card->departure_time_layer, fonts_get_system_font(is_large_display ? FONT_KEY_GOTHIC_18 : FONT_KEY_GOTHIC_14));
+  text_layer_set_text_alignment(card->departure_time_layer, GTextAlignmentLeft);
+  text_layer_set_background_color(card->departure_time_layer, GColorClear);
+  text_layer_set_text_color(card->departure_time_layer, GColorBlack);
+  layer_add_child(card->layer, text_layer_get_layer(card->departure_time_layer));
+
+  card->time_arrow_layer = text_layer_create(PBL_IF_ROUND_ELSE(GRect(47, platform_y + 4, 15, 20), GRect(x_offset + (is_large_display ? 40 : 30), platform_y + 2, is_large_display ? 20 : 15, 20)));
+  text_layer_set_font(card->time_arrow_layer, fonts_get_system_font(is_large_display ? FONT_KEY_GOTHIC_18 : FONT_KEY_GOTHIC_14));
+  text_layer_set_text_alignment(card->time_arrow_layer, GTextAlignmentCenter);
+  text_layer_set_background_color(card->time_arrow_layer, GColorClear);
+  text_layer_set_text_color(card->time_arrow_layer, GColorBlack);
   #ifdef PBL_PLATFORM_APLITE
-  text_layer_set_text(s_app.countdown_ui.time_arrow_layer, ">");
+  text_layer_set_text(card->time_arrow_layer, ">");
   #else
-  text_layer_set_text(s_app.countdown_ui.time_arrow_layer, "→");
+  text_layer_set_text(card->time_arrow_layer, "→");
   #endif
-  layer_add_child(window_layer, text_layer_get_layer(s_app.countdown_ui.time_arrow_layer));
+  layer_add_child(card->layer, text_layer_get_layer(card->time_arrow_layer));
 
-  s_app.countdown_ui.arrival_time_layer = text_layer_create(PBL_IF_ROUND_ELSE(GRect(62, platform_y + 4, 30, 20), GRect(x_offset + (is_large_display ? 60 : 45), platform_y + 2, is_large_display ? 40 : 30, 20)));
-  text_layer_set_font(s_app.countdown_ui.arrival_time_layer, fonts_get_system_font(is_large_display ? FONT_KEY_GOTHIC_18 : FONT_KEY_GOTHIC_14));
-  text_layer_set_text_alignment(s_app.countdown_ui.arrival_time_layer, GTextAlignmentLeft);
-  text_layer_set_background_color(s_app.countdown_ui.arrival_time_layer, GColorClear);
-  text_layer_set_text_color(s_app.countdown_ui.arrival_time_layer, GColorBlack);
-  layer_add_child(window_layer, text_layer_get_layer(s_app.countdown_ui.arrival_time_layer));
+  card->arrival_time_layer = text_layer_create(PBL_IF_ROUND_ELSE(GRect(62, platform_y + 4, 30, 20), GRect(x_offset + (is_large_display ? 60 : 45), platform_y + 2, is_large_display ? 40 : 30, 20)));
+  text_layer_set_font(card->arrival_time_layer, fonts_get_system_font(is_large_display ? FONT_KEY_GOTHIC_18 : FONT_KEY_GOTHIC_14));
+  text_layer_set_text_alignment(card->arrival_time_layer, GTextAlignmentLeft);
+  text_layer_set_background_color(card->arrival_time_layer, GColorClear);
+  text_layer_set_text_color(card->arrival_time_layer, GColorBlack);
+  layer_add_child(card->layer, text_layer_get_layer(card->arrival_time_layer));
 
   const int platform_size = is_large_display ? 32 : 24;
-  s_app.countdown_ui.platform_border_layer = layer_create(PBL_IF_ROUND_ELSE(GRect(118, platform_y + 2, 24, 24), GRect(90 + platform_x_offset, platform_y + 6, platform_size, platform_size)));
-  layer_set_update_proc(s_app.countdown_ui.platform_border_layer, prv_platform_border_update_proc);
-  layer_add_child(window_layer, s_app.countdown_ui.platform_border_layer);
-
-  s_app.countdown_ui.platform_number_layer = text_layer_create(PBL_IF_ROUND_ELSE(GRect(120, platform_y + 4, 20, 24), GRect(92 + platform_x_offset, platform_y + 8, is_large_display ? 28 : 20, is_large_display ? 32 : 24)));
-  text_layer_set_font(s_app.countdown_ui.platform_number_layer, fonts_get_system_font(is_large_display ? FONT_KEY_GOTHIC_24_BOLD : FONT_KEY_GOTHIC_18_BOLD));
-  text_layer_set_text_alignment(s_app.countdown_ui.platform_number_layer, GTextAlignmentCenter);
-  text_layer_set_background_color(s_app.countdown_ui.platform_number_layer, GColorClear);
-  text_layer_set_text_color(s_app.countdown_ui.platform_number_layer, GColorOxfordBlue);
-  layer_add_child(window_layer, text_layer_get_layer(s_app.countdown_ui.platform_number_layer));
-
-  s_app.countdown_ui.delay_layer = text_layer_create(PBL_IF_ROUND_ELSE(GRect(0, delay_y, bounds.size.w, 30), GRect(x_offset, delay_y - 2, bounds.size.w - x_offset - 5, is_large_display ? 40 : 30)));
-  text_layer_set_font(s_app.countdown_ui.delay_layer, fonts_get_system_font(is_large_display ? FONT_KEY_GOTHIC_28_BOLD : FONT_KEY_GOTHIC_24_BOLD));
-  text_layer_set_text_alignment(s_app.countdown_ui.delay_layer, PBL_IF_ROUND_ELSE(GTextAlignmentCenter, GTextAlignmentLeft));
-  text_layer_set_background_color(s_app.countdown_ui.delay_layer, GColorClear);
-  text_layer_set_text_color(s_app.countdown_ui.delay_layer, GColorBlack);
-  layer_add_child(window_layer, text_layer_get_layer(s_app.countdown_ui.delay_layer));
-
-  s_app.countdown_ui.countdown_layer = text_layer_create(PBL_IF_ROUND_ELSE(GRect(0, countdown_y, bounds.size.w, 50), GRect(x_offset, countdown_y - 2, bounds.size.w - x_offset - 5, is_large_display ? 60 : 50)));
-  text_layer_set_text(s_app.countdown_ui.countdown_layer, "Loading...");
-  text_layer_set_font(s_app.countdown_ui.countdown_layer, fonts_get_system_font(is_large_display ? FONT_KEY_LECO_42_NUMBERS : FONT_KEY_LECO_36_BOLD_NUMBERS));
-  text_layer_set_text_alignment(s_app.countdown_ui.countdown_layer, PBL_IF_ROUND_ELSE(GTextAlignmentCenter, GTextAlignmentLeft));
-  text_layer_set_background_color(s_app.countdown_ui.countdown_layer, GColorClear);
-  text_layer_set_text_color(s_app.countdown_ui.countdown_layer, GColorBlack);
-  layer_add_child(window_layer, text_layer_get_layer(s_app.countdown_ui.countdown_layer));
+  card->platform_border_layer = layer_create(PBL_IF_ROUND_ELSE(GRect(118, platform_y + 2, 24, 24), GRect(90 + platform_x_offset, platform_y + 6, platform_size, platform_size)));
+  layer_set_update_proc(card->platform_border_layer, prv_platform_border_update_proc);
+  layer_add_child(card->layer, card->platform_border_layer);
+
+  card->platform_number_layer = text_layer_create(PBL_IF_ROUND_ELSE(GRect(120, platform_y + 4, 20, 24), GRect(92 + platform_x_offset, platform_y + 8, is_large_display ? 28 : 20, is_large_display ? 32 : 24)));
+  text_layer_set_font(card->platform_number_layer, fonts_get_system_font(is_large_display ? FONT_KEY_GOTHIC_24_BOLD : FONT_KEY_GOTHIC_18_BOLD));
+  text_layer_set_text_alignment(card->platform_number_layer, GTextAlignmentCenter);
+  text_layer_set_background_color(card->platform_number_layer, GColorClear);
+  text_layer_set_text_color(card->platform_number_layer, GColorOxfordBlue);
+  layer_add_child(card->layer, text_layer_get_layer(card->platform_number_layer));
+
+  card->delay_layer = text_layer_create(PBL_IF_ROUND_ELSE(GRect(0, delay_y, bounds.size.w, 30), GRect(x_offset, delay_y - 2, bounds.size.w - x_offset - 5, is_large_display ? 40 : 30)));
+  text_layer_set_font(card->delay_layer, fonts_get_system_font(is_large_display ? FONT_KEY_GOTHIC_28_BOLD : FONT_KEY_GOTHIC_24_BOLD));
+  text_layer_set_text_alignment(card->delay_layer, PBL_IF_ROUND_ELSE(GTextAlignmentCenter, GTextAlignmentLeft));
+  text_layer_set_background_color(card->delay_layer, GColorClear);
+  text_layer_set_text_color(card->delay_layer, GColorBlack);
+  layer_add_child(card->layer, text_layer_get_layer(card->delay_layer));
+
+  card->countdown_layer = text_layer_create(PBL_IF_ROUND_ELSE(GRect(0, countdown_y, bounds.size.w, 50), GRect(x_offset, countdown_y - 2, bounds.size.w - x_offset - 5, is_large_display ? 60 : 50)));
+  text_layer_set_text(card->countdown_layer, "Loading...");
+  card->countdown_font = s_app.state.countdown_number_font;
+  card->countdown_buffer[0] = '\0';
+  text_layer_set_font(card->countdown_layer, s_app.state.countdown_number_font);
+  text_layer_set_text_alignment(card->countdown_layer, PBL_IF_ROUND_ELSE(GTextAlignmentCenter, GTextAlignmentLeft));
+  text_layer_set_background_color(card->countdown_layer, GColorClear);
+  text_layer_set_text_color(card->countdown_layer, GColorBlack);
+  layer_add_child(card->layer, text_layer_get_layer(card->countdown_layer));
+}
+
+static void prv_destroy_trip_card(TripCard *card) {
+  text_layer_destroy(card->platform_number_layer);
+  layer_destroy(card->platform_border_layer);
+  text_layer_destroy(card->countdown_layer);
+  text_layer_destroy(card->departure_time_layer);
+  text_layer_destroy(card->time_arrow_layer);
+  text_layer_destroy(card->arrival_time_layer);
+  text_layer_destroy(card->delay_layer);
+  layer_destroy(card->trip_leg_layer);
+  layer_destroy(card->layer);
+}
+
+static void prv_countdown_window_load(Window *window) {
+  heap_debug_window_loading(HEAP_SCOPE_COUNTDOWN);
+  Layer *window_layer = window_get_root_layer(window);
+  GRect bounds = layer_get_bounds(window_layer);
+  s_app.journey.selected_trip_index = prv_first_upcoming_trip_index();
+  if (s_app.journey.selected_trip_index < 0) { s_app.journey.selected_trip_index = 0; }
+
+  s_app.countdown_ui.station_font = fonts_get_system_font((bounds.size.w == 200) ? FONT_KEY_GOTHIC_28_BOLD : FONT_KEY_GOTHIC_24_BOLD);
+  s_app.countdown_ui.chrome_layer = layer_create(bounds);
+  layer_set_update_proc(s_app.countdown_ui.chrome_layer, prv_countdown_chrome_update_proc);
+  layer_add_child(window_layer, s_app.countdown_ui.chrome_layer);
+
+  #ifdef PBL_ROUND
+  const bool is_large_display = false;
+  #else
+  const bool is_large_display = (bounds.size.w == 200);
+  #endif
+  s_app.state.countdown_number_font = fonts_get_system_font(is_large_display ? FONT_KEY_LECO_42_NUMBERS : FONT_KEY_LECO_36_BOLD_NUMBERS);
+
+  for (int i = 0; i < TRIP_CARD_COUNT; i++) {
+    prv_create_trip_card(&s_app.countdown_ui.cards[i], window_layer, bounds);
+  }
+  s_app.countdown_ui.current = &s_app.countdown_ui.cards[0];
+  s_app.countdown_ui.previous = &s_app.countdown_ui.cards[1];
+  s_app.countdown_ui.next = &s_app.countdown_ui.cards[2];
+  s_app.countdown_ui.incoming = NULL;
+  layer_set_hidden(s_app.countdown_ui.previous->layer, true);
+  layer_set_hidden(s_app.countdown_ui.next->layer, true);
 
   s_app.countdown_ui.clock_layer = text_layer_create(PBL_IF_ROUND_ELSE(GRect(0, 0, bounds.size.w, 16), GRect(0, 0, bounds.size.w, is_large_display ? 20 : 16)));
   text_layer_set_font(s_app.countdown_ui.clock_layer, fonts_get_system_font(is_large_display ? FONT_KEY_GOTHIC_18 : FONT_KEY_GOTHIC_14));
@@ -824,49 +1559,38 @@ static void prv_countdown_click_config_provider(void *context) {
   text_layer_set_background_color(s_app.countdown_ui.clock_layer, GColorClear);
   text_layer_set_text_color(s_app.countdown_ui.clock_layer, GColorWhite);
   layer_add_child(window_layer, text_layer_get_layer(s_app.countdown_ui.clock_layer));
+  s_app.buffers.clock_buffer[0] = '\0';
 
-  prv_clock_timer_callback(NULL);
+  time_t now = time(NULL);
+  prv_update_clock(localtime(&now));
+
+  prv_prepare_trip_cards();
+  prv_send_selected_trip(s_app.journey.selected_trip_index);
 
-  prv_update_countdown_display();
+  heap_debug_window_loaded(HEAP_SCOPE_COUNTDOWN);
 }
 
 static void prv_countdown_window_unload(Window *window) {
-  if (s_app.state.countdown_timer) {
-    app_timer_cancel(s_app.state.countdown_timer);
-    s_app.state.countdown_timer = NULL;
-  }
-
-  if (s_app.state.clock_timer) {
-    app_timer_cancel(s_app.state.clock_timer);
-    s_app.state.clock_timer = NULL;
-  }
+  prv_send_selected_trip(-1);
 
-  // Unschedule animation if running, but don't destroy (animations auto-free when complete)
-  if (s_app.state.content_animation) {
-    animation_unschedule((Animation*)s_app.state.content_animation);
-    property_animation_destroy(s_app.state.content_animation);
-    s_app.state.content_animation = NULL;
-  }
+  // Settle a running slide while its cards still exist
+  prv_stop_trip_card_animation();
   s_app.state.is_animating = false;
 
-  text_layer_destroy(s_app.countdown_ui.destination_layer);
-  text_layer_destroy(s_app.countdown_ui.start_station_layer);
-  layer_destroy(s_app.countdown_ui.platform_border_layer);
-  text_layer_destroy(s_app.countdown_ui.platform_number_layer);
-  text_layer_destroy(s_app.countdown_ui.countdown_layer);
+  tick_timer_service_unsubscribe();
+  s_app.state.tick_units = 0;
+
   text_layer_destroy(s_app.countdown_ui.clock_layer);
-  text_layer_destroy(s_app.countdown_ui.departure_time_layer);
-  text_layer_destroy(s_app.countdown_ui.time_arrow_layer);
-  text_layer_destroy(s_app.countdown_ui.arrival_time_layer);
-  text_layer_destroy(s_app.countdown_ui.delay_layer);
 
-  layer_destroy(s_app.countdown_ui.trip_leg_layer);
+  for (int i = 0; i < TRIP_CARD_COUNT; i++) {
+    prv_destroy_trip_card(&s_app.countdown_ui.cards[i]);
+  }
+  trip_leg_cache_clear();
 
-  layer_destroy(s_app.countdown_ui.bg_blue_layer);
-  layer_destroy(s_app.countdown_ui.bg_blue_bottom_layer);
-  #ifdef PBL_COLOR
-    layer_destroy(s_app.countdown_ui.bg_yellow_layer);
-  #endif
+  layer_destroy(s_app.countdown_ui.chrome_layer);
+  window_destroy(window);
+  s_app.windows.countdown_window = NULL;
+  heap_debug_window_unloaded(HEAP_SCOPE_COUNTDOWN);
 }
 
 int main(void) {
@@ -17,16 +17,169 @@
 
 #pragma once
 #include <pebble.h>
+#include "station_search.h"
+#include "tracked_trip.h"
 
 // --- Constants ---
 #define MAX_STATIONS 8
 #define MAX_STATION_NAME_LENGTH 32
 #define MAX_STATION_CODE_LENGTH 5
+#define MAX_STATION_POOL_LENGTH 96
 #define MAX_TRIPS 5
-#define MAX_DATE_TIME_LENGTH 25
-#define MAX_TRANSFERS_LENGTH 3
-#define MAX_PLATFORM_LENGTH 3
-#define MAX_DELAY_LENGTH 10
+#define MAX_PLATFORM_LENGTH (TRIP_RECORD_PLATFORM_LENGTH + 1)  // Whole record field plus NUL
+
+// --- Station Search ---
+#define MAX_SEARCH_LENGTH 12
+#define SEARCH_ALPHABET "ABCDEFGHIJKLMNOPQRSTUVWXYZ '-."
+#define SEARCH_PREVIEW_COUNT 3    // Matches listed under the prefix
+#define SEARCH_AUTO_LIST_COUNT 4  // Open the result list once this few stations match
+
+// --- AppMessage Buffers ---
+// The inbox is sized from app_message_inbox_size_maximum() but capped by a
+// per-platform budget; its final size is reported to the phone (INBOX_SIZE).
+#ifdef PBL_PLATFORM_APLITE
+#define APP_MESSAGE_INBOX_BUDGET 512
+#else
+#define APP_MESSAGE_INBOX_BUDGET 2048
+#endif
+#define APP_MESSAGE_OUTBOX_SIZE 128
+
+// --- Chunked Transfer Protocol ---
+// Payloads larger than the inbox arrive as CHUNK_DATA messages tagged with the
+// payload's message key (CHUNK_KEY), a sequence number (CHUNK_SEQ), the number
+// of chunks (CHUNK_COUNT) and the total payload length (CHUNK_LENGTH). All
+// chunks except the last have the same size, so no offset is sent.
+#define MAX_CHUNKED_PAYLOAD_LENGTH 512
+#define MAX_CHUNKS 32
+
+// --- Station List Protocol ---
+// STATION_LIST is a single byte array: a header (version, station count) followed
+// by one little-endian uint16 index into all_stations per station. An index of
+// STATION_INDEX_UNKNOWN is followed by the station's code and name, each as a
+// length byte plus that many characters.
+#define STATION_LIST_VERSION 1
+#define STATION_LIST_HEADER_SIZE 2
+#define STATION_INDEX_UNKNOWN 0xFFFF
+
+// --- Trip Record Protocol ---
+// TRIP_DATA is a single byte array: a header (version, trip count) followed by
+// `count` fixed-size trip records. All integers are little-endian.
+#define TRIP_RECORD_VERSION 1
+#define TRIP_RECORD_HEADER_SIZE 2
+#define TRIP_RECORD_SIZE 24
+#define TRIP_RECORD_OFFSET_DEPARTURE 0          // int32, actual departure epoch
+#define TRIP_RECORD_OFFSET_PLANNED_DEPARTURE 4  // int32, planned departure epoch
+#define TRIP_RECORD_OFFSET_PLANNED_ARRIVAL 8    // int32, planned arrival epoch (0 if unknown)
+#define TRIP_RECORD_OFFSET_ARRIVAL 12           // int32, actual arrival epoch (0 if unknown)
+#define TRIP_RECORD_OFFSET_DELAY 16             // int16, departure delay in minutes
+#define TRIP_RECORD_OFFSET_TRANSFERS 18         // uint8
+#define TRIP_RECORD_OFFSET_FLAGS 19             // uint8, TRIP_FLAG_* bits
+#define TRIP_RECORD_OFFSET_PLATFORM 20          // char[4], NUL padded
+#define TRIP_RECORD_PLATFORM_LENGTH 4
+
+#define TRIP_FLAG_CANCELLED 0x01
+
+// --- Trip Delta Protocol ---
+// While the countdown is open the watch reports the selected trip index with
+// TRIP_SELECTED (-1 when it closes). The phone re-polls that trip and sends
+// TRIP_DELTA byte arrays: version, trip index, a TRIP_DELTA_* field mask, then
+// only the masked fields, in the order of the mask bits.
+#define TRIP_DELTA_VERSION 1
+#define TRIP_DELTA_HEADER_SIZE 3
+#define TRIP_DELTA_DELAY 0x01      // int16, minutes
+#define TRIP_DELTA_PLATFORM 0x02   // char[TRIP_RECORD_PLATFORM_LENGTH]
+#define TRIP_DELTA_DEPARTURE 0x04  // int32, actual departure epoch
+#define TRIP_DELTA_FLAGS 0x08      // uint8, TRIP_FLAG_* bits
+
+// --- Timetable Resource ---
+// RESOURCE_ID_TIMETABLE (resources/data/timetable.bin, packed from
+// timetable.json by tools/generate_timetable.py) holds scheduled departures
+// for a few routes, used when no live data can be fetched. Routes entered on
+// the phone's settings page are packed the same way and sent as TIMETABLE.
+// All integers are little-endian. Layout:
+//   header       magic "TT", version, route count
+//   route[count] from and to station (uint16 all_stations indices), uint32
+//                offset of the route's block, uint16 departure count,
+//                uint8 platform count, uint8 service count
+//   block        platform[platform count] (char[4], NUL padded),
+//                service[service count], uint16 hour index[25] (first
+//                departure in each hour, then the departure count), then one
+//                record per departure sorted by time of day
+//   service      day mask (bit 0 is Sunday), duration in minutes,
+//                transfers << 4 | platform (0xF: none)
+//   record       minute within its hour, service index
+// Departures share everything but their time with the others of their
+// service, so a record only takes two bytes.
+#define TIMETABLE_VERSION 3
+#define TIMETABLE_HEADER_SIZE 4
+#define TIMETABLE_ROUTE_SIZE 12
+#define TIMETABLE_PLATFORM_SIZE 4
+#define TIMETABLE_SERVICE_SIZE 3
+#define TIMETABLE_MAX_SERVICES 16  // Per route, all are read into RAM for a lookup
+#define TIMETABLE_HOUR_INDEX_COUNT 25
+#define TIMETABLE_RECORD_SIZE 2
+#define TIMETABLE_NO_PLATFORM 0x0F
+// The synced timetable is kept in persist, split into pages of
+// TIMETABLE_PAGE_SIZE bytes under PERSIST_KEY_TIMETABLE_BASE
+#define TIMETABLE_MAX_SYNCED_LENGTH MAX_CHUNKED_PAYLOAD_LENGTH
+#define TIMETABLE_PAGE_SIZE 128
+
+// --- Error Codes ---
+// ERROR carries one of these, so the watch can tell a missing API key from a
+// dropped connection.
+#define ERROR_AUTH 1          // The API rejected the key
+#define ERROR_NETWORK 2       // No answer from the API, even after retrying
+#define ERROR_RATE_LIMITED 3  // Too many requests against the API quota
+#define ERROR_SERVER 4        // The API failed or sent something unreadable
+#define ERROR_NO_RESULTS 5    // No stations nearby or no trips found
+#define ERROR_LOCATION 6      // The phone could not get a location
+
+// --- Prefetch Hint Protocol ---
+// While a destination list is open the watch sends the start station
+// (START_STATION_CODE) with a PREFETCH_HINT byte array: version, station
+// count, then one little-endian uint16 index into all_stations per station,
+// highlighted row first. The phone prefetches those trips so selecting one
+// usually needs no round trip to the API.
+#define PREFETCH_HINT_VERSION 1
+#define PREFETCH_HINT_HEADER_SIZE 2
+#define PREFETCH_HINT_MAX_STATIONS 3   // Highlighted row and both neighbours
+#define PREFETCH_HINT_DELAY_MS 300     // Wait for scrolling to settle
+
+// --- Persistent Storage ---
+// The route cache may use half of the 4 KB per-app persist budget. Each route
+// costs one trip payload plus one entry in the cache index, and the index
+// itself has to fit in a single PERSIST_DATA_MAX_LENGTH value. The synced
+// timetable takes at most another TIMETABLE_MAX_SYNCED_LENGTH bytes.
+#define PERSIST_STORAGE_BUDGET 4096
+#define ROUTE_CACHE_BUDGET (PERSIST_STORAGE_BUDGET / 2)
+#define ROUTE_CACHE_PAYLOAD_SIZE (TRIP_RECORD_HEADER_SIZE + MAX_TRIPS * TRIP_RECORD_SIZE)
+#define MAX_CACHED_ROUTES 12
+
+#define PERSIST_KEY_ROUTE_CACHE_INDEX 1
+#define PERSIST_KEY_REMINDER 2
+// PERSIST_KEY_REMINDER_LEAD and PERSIST_KEY_TRACKED_TRIP are in tracked_trip.h
+#define PERSIST_KEY_TIMETABLE_LENGTH 5
+#define PERSIST_KEY_ROUTE_CACHE_BASE 100  // One key per cache slot
+#define PERSIST_KEY_TIMETABLE_BASE 200    // One key per timetable page
+
+// --- Departure Reminder ---
+// A reminder wakes the app a lead time before the selected train departs. The
+// lead time is set on the phone's settings page and sent as REMINDER_LEAD.
+// The default lead time is shared with the worker, see tracked_trip.h.
+#define MAX_REMINDER_LEAD_MINUTES 60
+
+// Stored under PERSIST_KEY_REMINDER, see reminder.h
+typedef struct {
+  char start_code[MAX_STATION_CODE_LENGTH];
+  char dest_code[MAX_STATION_CODE_LENGTH];
+  char dest_name[MAX_STATION_NAME_LENGTH];
+  int32_t planned_departure;  // Identifies the trip in fresh TRIP_DATA
+  int32_t departure;          // Last known values when it was scheduled
+  int16_t delay;
+  uint8_t flags;
+  char platform[MAX_PLATFORM_LENGTH];
+  WakeupId wakeup_id;
+} Reminder;
 
 // --- Data Structures ---
 
@@ -37,6 +190,9 @@ typedef struct {
   Window *dest_menu_window;
   Window *alpha_menu_window;
   Window *countdown_window;
+  Window *search_window;
+  Window *search_results_window;
+  Window *reminder_window;
 } AppWindows;
 
 // Menu Layer Components
@@ -44,6 +200,7 @@ typedef struct {
   MenuLayer *menu_layer;
   MenuLayer *dest_menu_layer;
   MenuLayer *alpha_menu_layer;
+  MenuLayer *search_results_menu_layer;
 } AppMenuLayers;
 
 // Main Window Text Layers
@@ -56,57 +213,92 @@ typedef struct {
   #endif
 } MainWindowUI;
 
-// Countdown Window UI Components
+// One trip on the countdown window. The window keeps three of these: the
+// selected trip and both of its neighbours, so switching trips only slides a
+// card that is already filled in.
 typedef struct {
+  Layer *layer;                // Container, slid in and out as a whole
   TextLayer *platform_number_layer;
   Layer *platform_border_layer;
   TextLayer *countdown_layer;
-  TextLayer *start_station_layer;
-  TextLayer *destination_layer;
   TextLayer *departure_time_layer;
   TextLayer *time_arrow_layer;
   TextLayer *arrival_time_layer;
   TextLayer *delay_layer;
-  TextLayer *clock_layer;
   Layer *trip_leg_layer;
+  int trip_index;
+  GFont countdown_font;        // Font currently set on the countdown layer
+  char countdown_buffer[16];
+  char departure_time_buffer[6];
+  char arrival_time_buffer[6];
+  char delay_buffer[10];
+} TripCard;
+
+#define TRIP_CARD_COUNT 3
+
+// Countdown Window UI Components
+typedef struct {
+  TripCard cards[TRIP_CARD_COUNT];
+  TripCard *current;           // Shows the selected trip
+  TripCard *previous;          // Prepared for UP
+  TripCard *next;              // Prepared for DOWN
+  TripCard *incoming;          // Sliding in while animating
+  TextLayer *clock_layer;
+  Layer *chrome_layer;         // Bars, background and station names, drawn in one pass
+  GFont station_font;
+} CountdownWindowUI;
+
+// Search Window UI Components
+typedef struct {
+  TextLayer *prefix_layer;
+  TextLayer *count_layer;
+  TextLayer *preview_layer;
   Layer *bg_blue_layer;
-  Layer *bg_blue_bottom_layer;
   #ifdef PBL_COLOR
   Layer *bg_yellow_layer;
   #endif
-} CountdownWindowUI;
+} SearchWindowUI;
 
-// Display Buffers for Countdown Window
+// Reminder Window UI Components
+typedef struct {
+  TextLayer *title_layer;
+  TextLayer *detail_layer;
+  char detail_buffer[80];
+} ReminderWindowUI;
+
+// Display Buffers
 typedef struct {
-  char platform_buffer[32];
-  char countdown_buffer[16];
-  char departure_time_buffer[6];
-  char arrival_time_buffer[6];
-  char delay_buffer[10];
   char clock_buffer[6];
   char section_header[16];
   char letter_str[2];
+  char search_prefix_buffer[MAX_SEARCH_LENGTH + 4];  // Prefix plus "[c]"
+  char search_count_buffer[16];
+  char search_preview_buffer[SEARCH_PREVIEW_COUNT * MAX_STATION_NAME_LENGTH];
 } DisplayBuffers;
 
 // Station Data (nearby stations from API)
 typedef struct {
-  char names[MAX_STATIONS][MAX_STATION_NAME_LENGTH];
-  char codes[MAX_STATIONS][MAX_STATION_CODE_LENGTH];
+  const char *names[MAX_STATIONS];  // Point into all_stations or pool
+  const char *codes[MAX_STATIONS];
+  char pool[MAX_STATION_POOL_LENGTH];  // Strings for stations missing from all_stations
   int count;
   bool loaded;
 } StationData;
 
-// Trip Data (journey information)
+// Trip Data (journey information, decoded from TRIP_DATA records)
 typedef struct {
-  char planned_departures[MAX_TRIPS][MAX_DATE_TIME_LENGTH];
-  int departures[MAX_TRIPS];  // Unix epoch timestamps
-  char planned_arrivals[MAX_TRIPS][MAX_DATE_TIME_LENGTH];
-  char arrivals[MAX_TRIPS][MAX_DATE_TIME_LENGTH];
-  char transfers[MAX_TRIPS][MAX_TRANSFERS_LENGTH];
+  int departures[MAX_TRIPS];          // Unix epoch timestamps
+  int planned_departures[MAX_TRIPS];  // Unix epoch timestamps
+  int planned_arrivals[MAX_TRIPS];    // Unix epoch timestamps, 0 if unknown
+  int arrivals[MAX_TRIPS];            // Unix epoch timestamps, 0 if unknown
+  int16_t delays[MAX_TRIPS];          // Minutes
+  uint8_t transfers[MAX_TRIPS];
+  uint8_t flags[MAX_TRIPS];           // TRIP_FLAG_* bits
   char platform[MAX_TRIPS][MAX_PLATFORM_LENGTH];
-  char delay[MAX_TRIPS][MAX_DELAY_LENGTH];
   int count;
   bool loaded;
+  bool stale;                         // Shown from the route cache, refresh pending
+  bool scheduled;                     // Taken from the offline timetable, not live
 } TripData;
 
 // Selected Journey Information
@@ -118,6 +310,32 @@ typedef struct {
   int selected_trip_index;
 } SelectedJourney;
 
+// Reassembly state for a chunked transfer
+typedef struct {
+  uint32_t key;
+  uint16_t length;
+  uint8_t chunk_count;
+  uint32_t received_mask;
+  uint8_t buffer[MAX_CHUNKED_PAYLOAD_LENGTH];
+} ChunkTransfer;
+
+// Prefix entered in the search window. ranges[n] holds the matches for the
+// first n characters, so removing a character needs no search.
+typedef struct {
+  char prefix[MAX_SEARCH_LENGTH + 1];
+  uint8_t length;
+  char candidate;  // Next character, added with SELECT
+  StationSearchRange ranges[MAX_SEARCH_LENGTH + 1];
+} SearchState;
+
+// Stations around the highlighted destination row, waiting to be hinted
+typedef struct {
+  uint16_t stations[PREFETCH_HINT_MAX_STATIONS];
+  uint8_t count;
+  AppTimer *timer;
+  bool pending;  // The outbox was busy, send once it frees up
+} PrefetchHint;
+
 // Animation Direction
 typedef enum {
   ANIMATION_DIRECTION_UP = -1,
@@ -128,13 +346,19 @@ typedef enum {
 typedef struct {
   int last_selected_index;
   int selected_alphabet_index;
-  time_t departure_time;
-  AppTimer *countdown_timer;
-  AppTimer *clock_timer;
+  TimeUnits tick_units;        // Current tick service resolution, 0 if unsubscribed
+  GFont countdown_number_font;
   AppTimer *fallback_timer;
-  PropertyAnimation *content_animation;
+  uint32_t inbox_size;
+  bool refresh_pending;
+  int pending_selected_trip;
+  bool selected_trip_pending;
+  bool trip_request_pending;
+  bool awaiting_trips;          // A route was picked and nothing is shown for it yet
+  Animation *card_animation;   // Freed by the system once it stops
   bool is_animating;
   AnimationDirection animation_direction;
+  int pending_trip_steps;      // Presses made while a card was sliding, + for DOWN
 } AppState;
 
 // --- Global App Data Instance ---
@@ -143,9 +367,15 @@ typedef struct {
   AppMenuLayers menu_layers;
   MainWindowUI main_ui;
   CountdownWindowUI countdown_ui;
+  SearchWindowUI search_ui;
+  ReminderWindowUI reminder_ui;
   DisplayBuffers buffers;
   StationData stations;
   TripData trips;
   SelectedJourney journey;
+  ChunkTransfer transfer;
+  SearchState search;
+  PrefetchHint prefetch;
+  Reminder reminder;  // Set when a reminder woke the app
   AppState state;
 } AppData;
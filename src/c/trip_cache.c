@@ -0,0 +1,125 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <pebble.h>
+#include "trein_data.h"
+#include "trip_cache.h"
+
+// One entry per cache slot, stored together under PERSIST_KEY_ROUTE_CACHE_INDEX
+typedef struct {
+  char start_code[MAX_STATION_CODE_LENGTH];
+  char dest_code[MAX_STATION_CODE_LENGTH];
+  int32_t saved_at;   // 0 if the slot is unused
+  int32_t viewed_at;
+} RouteCacheEntry;
+
+_Static_assert(sizeof(RouteCacheEntry) * MAX_CACHED_ROUTES <= PERSIST_DATA_MAX_LENGTH,
+               "Route cache index does not fit in one persist value");
+_Static_assert((ROUTE_CACHE_PAYLOAD_SIZE + sizeof(RouteCacheEntry)) * MAX_CACHED_ROUTES <= ROUTE_CACHE_BUDGET,
+               "Route cache exceeds its share of the persist budget");
+
+static RouteCacheEntry s_index[MAX_CACHED_ROUTES];
+static bool s_index_loaded;
+
+static void prv_load_index(void) {
+  if (s_index_loaded) { return; }
+  memset(s_index, 0, sizeof(s_index));
+  if (persist_exists(PERSIST_KEY_ROUTE_CACHE_INDEX)) {
+    persist_read_data(PERSIST_KEY_ROUTE_CACHE_INDEX, s_index, sizeof(s_index));
+  }
+  s_index_loaded = true;
+}
+
+static void prv_save_index(void) {
+  persist_write_data(PERSIST_KEY_ROUTE_CACHE_INDEX, s_index, sizeof(s_index));
+}
+
+static int prv_find_slot(const char *start_code, const char *dest_code) {
+  for (int i = 0; i < MAX_CACHED_ROUTES; i++) {
+    if (s_index[i].saved_at != 0 &&
+        strncmp(s_index[i].start_code, start_code, MAX_STATION_CODE_LENGTH) == 0 &&
+        strncmp(s_index[i].dest_code, dest_code, MAX_STATION_CODE_LENGTH) == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// Pick a free slot, or the least recently viewed one
+static int prv_victim_slot(void) {
+  int victim = 0;
+  for (int i = 0; i < MAX_CACHED_ROUTES; i++) {
+    if (s_index[i].saved_at == 0) { return i; }
+    if (s_index[i].viewed_at < s_index[victim].viewed_at) { victim = i; }
+  }
+  return victim;
+}
+
+void trip_cache_store(const char *start_code, const char *dest_code, const uint8_t *data, uint16_t length) {
+  if (length > ROUTE_CACHE_PAYLOAD_SIZE) { length = ROUTE_CACHE_PAYLOAD_SIZE; }
+  prv_load_index();
+
+  int slot = prv_find_slot(start_code, dest_code);
+  if (slot < 0) {
+    slot = prv_victim_slot();
+    strncpy(s_index[slot].start_code, start_code, MAX_STATION_CODE_LENGTH - 1);
+    s_index[slot].start_code[MAX_STATION_CODE_LENGTH - 1] = '\0';
+    strncpy(s_index[slot].dest_code, dest_code, MAX_STATION_CODE_LENGTH - 1);
+    s_index[slot].dest_code[MAX_STATION_CODE_LENGTH - 1] = '\0';
+  }
+
+  if (persist_write_data(PERSIST_KEY_ROUTE_CACHE_BASE + slot, data, length) < 0) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Failed to cache trips for slot %d", slot);
+    s_index[slot].saved_at = 0;
+  } else {
+    s_index[slot].saved_at = time(NULL);
+    s_index[slot].viewed_at = s_index[slot].saved_at;
+  }
+  prv_save_index();
+}
+
+int trip_cache_load(const char *start_code, const char *dest_code, uint8_t *buffer, size_t size, time_t *saved_at) {
+  prv_load_index();
+  int slot = prv_find_slot(start_code, dest_code);
+  if (slot < 0) { return 0; }
+
+  int length = persist_read_data(PERSIST_KEY_ROUTE_CACHE_BASE + slot, buffer, size);
+  if (length <= 0) { return 0; }
+  if (saved_at) { *saved_at = s_index[slot].saved_at; }
+  return length;
+}
+
+void trip_cache_touch(const char *start_code, const char *dest_code) {
+  prv_load_index();
+  int slot = prv_find_slot(start_code, dest_code);
+  if (slot < 0) { return; }
+  s_index[slot].viewed_at = time(NULL);
+  prv_save_index();
+}
+
+bool trip_cache_last_route(char *start_code, char *dest_code) {
+  prv_load_index();
+  int last = -1;
+  for (int i = 0; i < MAX_CACHED_ROUTES; i++) {
+    if (s_index[i].saved_at != 0 && (last < 0 || s_index[i].viewed_at > s_index[last].viewed_at)) {
+      last = i;
+    }
+  }
+  if (last < 0) { return false; }
+  strncpy(start_code, s_index[last].start_code, MAX_STATION_CODE_LENGTH);
+  strncpy(dest_code, s_index[last].dest_code, MAX_STATION_CODE_LENGTH);
+  return true;
+}
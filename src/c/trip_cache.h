@@ -0,0 +1,38 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <pebble.h>
+
+// Persistent per-route cache of the last TRIP_DATA payload received for each
+// start/destination pair. Payloads are stored exactly as they came from the
+// phone, so a cache hit decodes through the same path as a live message.
+
+// Store the payload for a route, evicting the least recently viewed route
+// when every slot is taken. Also marks the route as the last viewed one.
+void trip_cache_store(const char *start_code, const char *dest_code, const uint8_t *data, uint16_t length);
+
+// Copy the cached payload for a route into buffer. Returns the payload length,
+// or 0 when the route is not cached. saved_at receives the time it was stored.
+int trip_cache_load(const char *start_code, const char *dest_code, uint8_t *buffer, size_t size, time_t *saved_at);
+
+// Mark a cached route as viewed so it becomes the last route and is evicted last
+void trip_cache_touch(const char *start_code, const char *dest_code);
+
+// Copy the codes of the most recently viewed cached route. Returns false if
+// the cache is empty. Both buffers must hold MAX_STATION_CODE_LENGTH bytes.
+bool trip_cache_last_route(char *start_code, char *dest_code);
@@ -0,0 +1,73 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "trip_format.h"
+
+int trip_format_first_upcoming(const TripData *trips, time_t now) {
+  for (int i = 0; i < trips->count; i++) {
+    if (trips->departures[i] > now) { return i; }
+  }
+  return -1;
+}
+
+int trip_format_countdown(time_t departure, uint8_t flags, time_t now, char *buffer, size_t size) {
+  if (departure == 0 || (flags & TRIP_FLAG_CANCELLED)) {
+    snprintf(buffer, size, "--:--");
+    return -1;
+  }
+
+  int remaining_seconds = departure - now;
+  if (remaining_seconds <= 0) {
+    snprintf(buffer, size, "Departed");
+    return 0;
+  }
+
+  int hours = remaining_seconds / 3600;
+  int minutes = (remaining_seconds % 3600) / 60;
+  int seconds = remaining_seconds % 60;
+  if (hours > 0) {
+    snprintf(buffer, size, "%02d:%02d", hours, minutes);
+  } else {
+    snprintf(buffer, size, "%02d:%02d", minutes, seconds);
+  }
+  return remaining_seconds;
+}
+
+void trip_format_clock_time(int epoch, char *buffer, size_t size) {
+  if (epoch == 0) {
+    snprintf(buffer, size, "--:--");
+    return;
+  }
+  time_t timestamp = epoch;
+  strftime(buffer, size, "%H:%M", localtime(&timestamp));
+}
+
+void trip_format_delay(const TripData *trips, int index, char *buffer, size_t size) {
+  if (trips->flags[index] & TRIP_FLAG_CANCELLED) {
+    snprintf(buffer, size, "%s", "");
+  } else if (trips->scheduled) {
+    // No live data, only the timetable
+    snprintf(buffer, size, "%s", "Scheduled");
+  } else if (trips->stale) {
+    // Cached delays may be outdated, so don't present them as live
+    snprintf(buffer, size, "%s", "Cached");
+  } else if (trips->delays[index] > 0) {
+    snprintf(buffer, size, "+%d", trips->delays[index]);
+  } else {
+    snprintf(buffer, size, "%s", "On time");
+  }
+}
@@ -0,0 +1,38 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <pebble.h>
+#include "trein_data.h"
+
+// Text shown on the countdown window, computed from TripData and the current
+// time only. Callers decide which layers, fonts and tick rates go with it.
+
+// Index of the first trip that has not departed at now, or -1 if all have left
+int trip_format_first_upcoming(const TripData *trips, time_t now);
+
+// Format the time left until departure as HH:MM, or MM:SS in the last hour,
+// "Departed" once it has left and "--:--" when it is unknown or cancelled.
+// Returns the seconds left, 0 once departed or -1 when unknown or cancelled.
+int trip_format_countdown(time_t departure, uint8_t flags, time_t now, char *buffer, size_t size);
+
+// Format an epoch timestamp as local HH:MM, or "--:--" when it is unknown
+void trip_format_clock_time(int epoch, char *buffer, size_t size);
+
+// Format the delay of a trip: "+N" minutes, "On time", "Cached" for trips
+// shown from the route cache, or nothing when the trip is cancelled
+void trip_format_delay(const TripData *trips, int index, char *buffer, size_t size);
@@ -0,0 +1,111 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "trip_leg.h"
+
+#ifdef PBL_ROUND
+typedef struct {
+  TripLegGeometry entries[TRIP_LEG_CACHE_SIZE];
+  uint32_t last_used[TRIP_LEG_CACHE_SIZE];  // 0 marks an empty entry
+  uint32_t clock;
+  GRect bounds;                             // Bounds every entry was laid out in
+} TripLegCache;
+
+static TripLegCache s_cache;
+#endif
+
+void trip_leg_layout(GRect bounds, int transfers, TripLegGeometry *geometry) {
+  int num_legs = transfers + 1;
+  if (num_legs > MAX_TRIP_LEGS) {
+    num_legs = MAX_TRIP_LEGS;
+  }
+  geometry->leg_count = num_legs;
+
+#ifdef PBL_ROUND
+  GPoint center = grect_center_point(&bounds);
+  int radius = (bounds.size.w / 2) - 8;
+
+  int32_t total_angle = TRIG_MAX_ANGLE * 80 / 360;
+  int32_t center_angle = TRIG_MAX_ANGLE / 4;
+  int32_t start_angle = center_angle - (total_angle / 2);
+
+  int32_t angle_per_leg = total_angle / num_legs;
+  int32_t gap_angle = angle_per_leg / 8;
+
+  geometry->polar_rect = GRect(center.x - radius, center.y - radius, radius * 2, radius * 2);
+
+  for (int i = 0; i < num_legs; i++) {
+    int32_t leg_start_angle_trig = start_angle + i * angle_per_leg + gap_angle;
+    int32_t leg_end_angle_trig = start_angle + (i + 1) * angle_per_leg - gap_angle;
+
+    geometry->angles[i * 2] = leg_start_angle_trig;
+    geometry->angles[i * 2 + 1] = leg_end_angle_trig;
+    geometry->dots[i * 2] = gpoint_from_polar(geometry->polar_rect, GOvalScaleModeFitCircle, leg_start_angle_trig);
+    geometry->dots[i * 2 + 1] = gpoint_from_polar(geometry->polar_rect, GOvalScaleModeFitCircle, leg_end_angle_trig);
+  }
+#else // PBL_RECT
+  int line_x = bounds.size.w - 12;
+  int total_height = bounds.size.h - 80;
+  int start_y = 40;
+
+  int height_per_leg = total_height / num_legs;
+  int gap_y = height_per_leg / 8;
+
+  for (int i = 0; i < num_legs; i++) {
+    int leg_start_y = start_y + i * height_per_leg + gap_y;
+    int leg_end_y = start_y + (i + 1) * height_per_leg - gap_y;
+
+    geometry->dots[i * 2] = GPoint(line_x, leg_start_y);
+    geometry->dots[i * 2 + 1] = GPoint(line_x, leg_end_y);
+  }
+#endif
+}
+
+#ifdef PBL_ROUND
+void trip_leg_cache_clear(void) {
+  memset(&s_cache, 0, sizeof(s_cache));
+}
+
+const TripLegGeometry *trip_leg_geometry(GRect bounds, int transfers, TripLegGeometry *scratch) {
+  if (!grect_equal(&bounds, &s_cache.bounds)) {
+    trip_leg_cache_clear();
+    s_cache.bounds = bounds;
+  }
+  int legs = (transfers + 1 > MAX_TRIP_LEGS) ? MAX_TRIP_LEGS : transfers + 1;
+
+  // Reuse an entry with this leg count, or else the least recently used one
+  int slot = 0;
+  for (int i = 0; i < TRIP_LEG_CACHE_SIZE; i++) {
+    if (s_cache.last_used[i] && s_cache.entries[i].leg_count == legs) {
+      s_cache.last_used[i] = ++s_cache.clock;
+      return &s_cache.entries[i];
+    }
+    if (s_cache.last_used[i] < s_cache.last_used[slot]) { slot = i; }
+  }
+  trip_leg_layout(bounds, transfers, &s_cache.entries[slot]);
+  s_cache.last_used[slot] = ++s_cache.clock;
+  return &s_cache.entries[slot];
+}
+#else // PBL_RECT
+void trip_leg_cache_clear(void) {
+}
+
+const TripLegGeometry *trip_leg_geometry(GRect bounds, int transfers, TripLegGeometry *scratch) {
+  trip_leg_layout(bounds, transfers, scratch);
+  return scratch;
+}
+#endif
@@ -0,0 +1,51 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <pebble.h>
+
+// Geometry of the trip-leg indicator: one segment per leg of the journey with
+// a dot at either end, down the right edge on rectangular displays and along
+// an arc on round ones.
+
+#define MAX_TRIP_LEGS 12
+#ifdef PBL_ROUND
+#define TRIP_LEG_CACHE_SIZE 3  // Trips on one route rarely differ in more transfer counts
+#endif
+
+typedef struct {
+  int leg_count;
+  GPoint dots[MAX_TRIP_LEGS * 2];    // Start and end of each leg
+  #ifdef PBL_ROUND
+  GRect polar_rect;                  // Circle the arcs are drawn on
+  int32_t angles[MAX_TRIP_LEGS * 2]; // Start and end angle of each leg
+  #endif
+} TripLegGeometry;
+
+// Lay out the legs of a trip with the given number of transfers in bounds
+void trip_leg_layout(GRect bounds, int transfers, TripLegGeometry *geometry);
+
+// Geometry for a trip with the given number of transfers in bounds. Round
+// layout needs trig, so it is laid out once and then served from a small
+// cache, keyed on the leg count and dropped as a whole when bounds differ from
+// the cached ones, e.g. when the unobstructed area changes. Rectangular layout
+// is a few additions and goes into scratch every time, which saves aplite the
+// memory of a cache.
+const TripLegGeometry *trip_leg_geometry(GRect bounds, int transfers, TripLegGeometry *scratch);
+
+// Drop all cached geometry, nothing to do on rectangular displays
+void trip_leg_cache_clear(void);
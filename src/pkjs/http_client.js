@@ -0,0 +1,187 @@
+//
+// * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+// * Copyright (c) 2025 Guus Beckett.
+// * 
+// * This program is free software: you can redistribute it and/or modify  
+// * it under the terms of the GNU General Public License as published by  
+// * the Free Software Foundation, version 3.
+// *
+// * This program is distributed in the hope that it will be useful, but 
+// * WITHOUT ANY WARRANTY; without even the implied warranty of 
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+// * General Public License for more details.
+// *
+// * You should have received a copy of the GNU General Public License 
+// * along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// JSON GET requests with retries and in-flight deduplication. A request for a
+// URL that is already being fetched joins that request instead of starting a
+// second one. Network errors, timeouts, 429 and 5xx responses are retried
+// with jittered exponential backoff; everything else fails at once. Callers
+// get a handle whose abort() drops their interest, and the request itself is
+// cancelled once nobody is waiting for it anymore.
+var TIMEOUT_MS = 4000;
+var MAX_RETRIES = 2;
+var BACKOFF_BASE_MS = 500;
+var MAX_RETRY_AFTER_MS = 10 * 1000;
+
+// Failure classes passed to onFailure
+var FAILURE_AUTH = "auth";                  // 401 or 403, the API key is missing or wrong
+var FAILURE_NETWORK = "network";            // No response, or it timed out
+var FAILURE_RATE_LIMITED = "rate_limited";  // 429
+var FAILURE_SERVER = "server";              // Any other status, or a response that is not JSON
+
+var inFlight = {};  // URL -> request shared by every caller of that URL
+
+function classifyStatus(status) {
+  if (status === 401 || status === 403) {
+    return FAILURE_AUTH;
+  }
+  if (status === 429) {
+    return FAILURE_RATE_LIMITED;
+  }
+  return FAILURE_SERVER;
+}
+
+function isTransient(failure, status) {
+  return failure === FAILURE_NETWORK || failure === FAILURE_RATE_LIMITED || status >= 500;
+}
+
+// Full jitter: a random delay up to the exponential bound, so clients that
+// failed together do not retry together. A Retry-After header wins if sent.
+function backoffDelay(attempt, xhr) {
+  var retryAfter = xhr ? parseInt(xhr.getResponseHeader("Retry-After"), 10) : NaN;
+  if (retryAfter >= 0) {
+    return Math.min(retryAfter * 1000, MAX_RETRY_AFTER_MS);
+  }
+  return Math.random() * BACKOFF_BASE_MS * Math.pow(2, attempt);
+}
+
+function settle(request, succeeded, value) {
+  delete inFlight[request.url];
+  request.callers.slice().forEach(function(caller) {
+    if (succeeded) {
+      caller.onSuccess(value);
+    } else if (caller.onFailure) {
+      caller.onFailure(value);
+    }
+  });
+}
+
+function attempt(request) {
+  var xhr = new XMLHttpRequest();
+  var finished = false;
+  request.xhr = xhr;
+
+  function fail(failure, status) {
+    if (finished || request.cancelled) {
+      return;
+    }
+    finished = true;
+    request.xhr = null;
+    if (request.attempt < MAX_RETRIES && isTransient(failure, status)) {
+      var delay = backoffDelay(request.attempt, failure === FAILURE_RATE_LIMITED ? xhr : null);
+      request.attempt++;
+      console.log("Request failed (" + failure + "), retry " + request.attempt + " in " + Math.round(delay) + " ms");
+      request.timer = setTimeout(function() {
+        request.timer = null;
+        attempt(request);
+      }, delay);
+      return;
+    }
+    settle(request, false, failure);
+  }
+
+  xhr.open("GET", request.url, true); // The "true" argument makes it asynchronous.
+  xhr.timeout = TIMEOUT_MS;
+  Object.keys(request.headers).forEach(function(name) {
+    xhr.setRequestHeader(name, request.headers[name]);
+  });
+
+  xhr.onload = function() {
+    if (finished || request.cancelled) {
+      return;
+    }
+    if (xhr.status < 200 || xhr.status >= 300) {
+      console.log("Did not receive OK. Status: " + xhr.status);
+      fail(classifyStatus(xhr.status), xhr.status);
+      return;
+    }
+
+    var data;
+    try {
+      data = JSON.parse(xhr.responseText);
+    } catch (e) {
+      console.log("Error parsing JSON response: " + e);
+      fail(FAILURE_SERVER, xhr.status);
+      return;
+    }
+    finished = true;
+    request.xhr = null;
+    settle(request, true, data);
+  };
+
+  xhr.onerror = function() {
+    console.log("Fetch error: A network error occurred.");
+    fail(FAILURE_NETWORK, 0);
+  };
+
+  xhr.ontimeout = function() {
+    console.log("Fetch error: Timed out after " + TIMEOUT_MS + " ms.");
+    fail(FAILURE_NETWORK, 0);
+  };
+
+  xhr.send();
+}
+
+function cancel(request) {
+  delete inFlight[request.url];
+  request.cancelled = true;
+  if (request.timer) {
+    clearTimeout(request.timer);
+    request.timer = null;
+  }
+  if (request.xhr) {
+    var xhr = request.xhr;
+    request.xhr = null;
+    xhr.abort();
+  }
+}
+
+// Fetch JSON from `url`. onSuccess receives the parsed body and onFailure one
+// of the FAILURE_* classes. Returns a handle with an abort() method; neither
+// callback runs after abort().
+function getJson(url, headers, onSuccess, onFailure) {
+  var request = inFlight[url];
+  if (!request) {
+    request = { url: url, headers: headers || {}, callers: [], attempt: 0, xhr: null, timer: null, cancelled: false };
+    inFlight[url] = request;
+    attempt(request);
+  } else {
+    console.log("Joining request already in flight");
+  }
+
+  var caller = { onSuccess: onSuccess, onFailure: onFailure };
+  request.callers.push(caller);
+
+  return {
+    abort: function() {
+      var index = request.callers.indexOf(caller);
+      if (index < 0) {
+        return;
+      }
+      request.callers.splice(index, 1);
+      if (request.callers.length === 0 && inFlight[url] === request) {
+        cancel(request);
+      }
+    }
+  };
+}
+
+module.exports = {
+  FAILURE_AUTH: FAILURE_AUTH,
+  FAILURE_NETWORK: FAILURE_NETWORK,
+  FAILURE_RATE_LIMITED: FAILURE_RATE_LIMITED,
+  FAILURE_SERVER: FAILURE_SERVER,
+  getJson: getJson
+};
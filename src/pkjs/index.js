@@ -14,11 +14,62 @@
 // * You should have received a copy of the GNU General Public License 
 // * along with this program. If not, see <http://www.gnu.org/licenses/>.
 //
+var messageKeys = require("message_keys");
+var stationTable = require("./station_table");
+var stationCache = require("./station_cache");
+var tripPrefetch = require("./trip_prefetch");
+var httpClient = require("./http_client");
+var tripModel = require("./trip_model");
+var timetable = require("./timetable");
+
 var DEFAULT_API_KEY = "";
-var BASE_API_URL = "https://gateway.apiportal.ns.nl";
+var DEFAULT_BASE_API_URL = "https://gateway.apiportal.ns.nl";
 var NEAREST_STATIONS_PATH = "/nsapp-stations/v2/nearest";
 var TRIP_PATH = "/reisinformatie-api/api/v3/trips";
 
+// AppMessage dictionary overhead: one count byte, then a 7-byte header per tuple
+var DICT_HEADER_SIZE = 1;
+var TUPLE_HEADER_SIZE = 7;
+// A chunk carries four uint32 tuples next to its data
+var CHUNK_OVERHEAD = DICT_HEADER_SIZE + 5 * TUPLE_HEADER_SIZE + 4 * 4;
+var CHUNK_WINDOW_SIZE = 4;
+var CHUNK_MAX_RETRIES = 3;
+
+// Inbox size of the watch; the watch reports its real size in its first message
+var watchInboxSize = 256;
+
+// Must match the "Station List Protocol" constants in src/c/trein_data.h
+var MAX_STATIONS = 8;
+var STATION_LIST_VERSION = 1;
+var STATION_INDEX_UNKNOWN = 0xffff;
+
+// Must match the "Trip Record Protocol" constants in src/c/trein_data.h
+var MAX_TRIPS = 5;
+var TRIP_RECORD_VERSION = 1;
+var TRIP_RECORD_HEADER_SIZE = 2;
+var TRIP_RECORD_SIZE = 24;
+var TRIP_RECORD_PLATFORM_LENGTH = 4;
+var TRIP_FLAG_CANCELLED = 0x01;
+
+// Must match the "Trip Delta Protocol" constants in src/c/trein_data.h
+var TRIP_DELTA_VERSION = 1;
+var TRIP_DELTA_DELAY = 0x01;
+var TRIP_DELTA_PLATFORM = 0x02;
+var TRIP_DELTA_DEPARTURE = 0x04;
+var TRIP_DELTA_FLAGS = 0x08;
+
+// Error codes sent as ERROR, see trein_data.h
+var ERROR_AUTH = 1;
+var ERROR_NETWORK = 2;
+var ERROR_RATE_LIMITED = 3;
+var ERROR_SERVER = 4;
+var ERROR_NO_RESULTS = 5;
+var ERROR_LOCATION = 6;
+
+// Prefetch hint protocol, see trein_data.h
+var PREFETCH_HINT_VERSION = 1;
+var PREFETCH_HINT_HEADER_SIZE = 2;
+
 function getApiKey() {
   try {
     var key = localStorage.getItem("api_key");
@@ -31,11 +82,76 @@ function getApiKey() {
   return DEFAULT_API_KEY;
 }
 
+// The API can be pointed elsewhere from the settings page, e.g. at
+// tools/mock_ns_server.py while developing in the emulator
+function getBaseApiUrl() {
+  try {
+    var url = localStorage.getItem("api_base_url");
+    if (url) {
+      return url.replace(/\/+$/, "");
+    }
+  } catch (e) {
+    console.log("Error reading from localStorage: " + e);
+  }
+  return DEFAULT_BASE_API_URL;
+}
+
+// Minutes before departure that a reminder set on the watch goes off. The
+// watch keeps its own copy, this one only fills in the settings page.
+var DEFAULT_REMINDER_LEAD = 5;
+
+function getReminderLead() {
+  try {
+    var lead = parseInt(localStorage.getItem("reminder_lead"), 10);
+    if (!isNaN(lead)) {
+      return lead;
+    }
+  } catch (e) {
+    console.log("Error reading from localStorage: " + e);
+  }
+  return DEFAULT_REMINDER_LEAD;
+}
+
+// Routes for the offline timetable as entered on the settings page, see
+// timetable.js
+function getTimetableText() {
+  try {
+    return localStorage.getItem("timetable") || "";
+  } catch (e) {
+    console.log("Error reading from localStorage: " + e);
+  }
+  return "";
+}
+
+// Send the timetable to the watch if it changed since it was last stored
+// there. Runs after the station list went out, so the two chunked transfers
+// do not interleave.
+function syncTimetable() {
+  if (localStorage.getItem("timetable_synced") !== "0") {
+    return;
+  }
+  var result = timetable.compile(getTimetableText());
+  for (var i = 0; i < result.errors.length; i++) {
+    console.log("Timetable: " + result.errors[i]);
+  }
+  sendPayload("TIMETABLE", result.bytes, function() {
+    localStorage.setItem("timetable_synced", "1");
+    console.log("Sent timetable with " + result.routeCount + " routes");
+  }, function(e) {
+    console.log("Failed to send timetable: " + e.error.message);
+  });
+}
+
 Pebble.addEventListener("showConfiguration", function(e) {
   var url = "https://guusbeckett.github.io/config.html";
   var currentKey = getApiKey();
+  var baseUrl = getBaseApiUrl();
+  if (baseUrl === DEFAULT_BASE_API_URL) {
+    baseUrl = "";
+  }
   
-  Pebble.openURL(url + "?api_key=" + encodeURIComponent(currentKey));
+  Pebble.openURL(url + "?api_key=" + encodeURIComponent(currentKey) + "&api_base_url=" + encodeURIComponent(baseUrl) +
+                 "&reminder_lead=" + getReminderLead() + "&timetable=" + encodeURIComponent(getTimetableText()));
 });
 
 Pebble.addEventListener("webviewclosed", function(e) {
@@ -50,6 +166,22 @@ Pebble.addEventListener("webviewclosed", function(e) {
       localStorage.setItem("api_key", settings.api_key);
       console.log("Saved new API key.");
     }
+    if (settings.api_base_url) {
+      localStorage.setItem("api_base_url", settings.api_base_url);
+      console.log("Using API at " + settings.api_base_url);
+    } else if (settings.api_base_url !== undefined) {
+      localStorage.removeItem("api_base_url");
+    }
+    var lead = parseInt(settings.reminder_lead, 10);
+    if (!isNaN(lead) && lead >= 0 && lead <= 60) {
+      localStorage.setItem("reminder_lead", lead);
+      Pebble.sendAppMessage({ "REMINDER_LEAD": lead });
+    }
+    if (settings.timetable !== undefined && settings.timetable !== getTimetableText()) {
+      localStorage.setItem("timetable", settings.timetable);
+      localStorage.setItem("timetable_synced", "0");
+      syncTimetable();
+    }
   } catch (err) {
     console.log("Error parsing settings: " + err);
   }
@@ -62,15 +194,27 @@ Pebble.addEventListener("ready", function(e) {
 });
 
 Pebble.addEventListener("appmessage", function(e) {
+  if (e.payload.INBOX_SIZE) {
+    watchInboxSize = e.payload.INBOX_SIZE;
+  }
+
   if (e.payload.REQUEST_STATIONS) {
     requestLocationAndFetchStations();
   }
 
+  if (e.payload.START_STATION_CODE && e.payload.PREFETCH_HINT) {
+    handlePrefetchHint(e.payload.START_STATION_CODE, e.payload.PREFETCH_HINT);
+  }
+
   if (e.payload.START_STATION_CODE && e.payload.DEST_STATION_CODE) {
     var startCode = e.payload.START_STATION_CODE;
     var destCode = e.payload.DEST_STATION_CODE;
     requestTrips(startCode, destCode);
   }
+
+  if (e.payload.TRIP_SELECTED !== undefined) {
+    selectLiveTrip(e.payload.TRIP_SELECTED);
+  }
 });
 
 function requestLocationAndFetchStations() {  
@@ -98,6 +242,8 @@ function requestLocationAndFetchStations() {
   );
 }
 
+// Nearby stations come from the NS API. Looking them up locally needs the
+// coordinates in stations.json, which are not checked in yet (see README).
 function locationSuccess(pos) {
   var lat = pos.coords.latitude;
   var lng = pos.coords.longitude;
@@ -108,199 +254,479 @@ function locationError(err) {
   console.log("Location error: " + err.message);
   console.log("Error code: " + err.code);
   
-  Pebble.sendAppMessage({
-    "ERROR": 1
-  });
+  sendError(ERROR_LOCATION);
 }
 
-function convertIsoDateToEpoch(apiDateString) {
-  if (!apiDateString || typeof apiDateString !== 'string') {
-    return 0;
+// Send a byte array payload to the watch under the given message key. Payloads
+// that do not fit the watch's inbox are split into chunks (see "Chunked Transfer
+// Protocol" in src/c/trein_data.h).
+function sendPayload(key, bytes, onSuccess, onFailure) {
+  if (DICT_HEADER_SIZE + TUPLE_HEADER_SIZE + bytes.length <= watchInboxSize) {
+    var message = {};
+    message[key] = bytes;
+    Pebble.sendAppMessage(message, onSuccess, onFailure);
+    return;
   }
+  sendChunked(key, bytes, onSuccess, onFailure);
+}
 
-  let compliantString = apiDateString.slice(0, -2) + ":" + apiDateString.slice(-2);
-  
-  let dateObject = new Date(compliantString);
-  
-  if (isNaN(dateObject)) {
-    return 0;
+// Stream a payload as chunks, keeping up to CHUNK_WINDOW_SIZE chunks waiting
+// for an ack at once. A nacked chunk is put back at the front of the queue and
+// resent on its own; the transfer fails once a chunk exceeds its retries.
+function sendChunked(key, bytes, onSuccess, onFailure) {
+  var chunkSize = watchInboxSize - CHUNK_OVERHEAD;
+  var count = Math.ceil(bytes.length / chunkSize);
+  var queue = [];
+  var retries = [];
+  var inFlight = 0;
+  var acked = 0;
+  var failed = false;
+
+  for (var seq = 0; seq < count; seq++) {
+    queue.push(seq);
+    retries.push(0);
+  }
+
+  function sendChunk(seq) {
+    inFlight++;
+    Pebble.sendAppMessage({
+      "CHUNK_KEY": messageKeys[key],
+      "CHUNK_SEQ": seq,
+      "CHUNK_COUNT": count,
+      "CHUNK_LENGTH": bytes.length,
+      "CHUNK_DATA": bytes.slice(seq * chunkSize, (seq + 1) * chunkSize)
+    }, function() {
+      inFlight--;
+      acked++;
+      if (acked === count) {
+        if (onSuccess) {
+          onSuccess();
+        }
+        return;
+      }
+      fillWindow();
+    }, function(e) {
+      inFlight--;
+      if (failed) {
+        return;
+      }
+      retries[seq]++;
+      if (retries[seq] > CHUNK_MAX_RETRIES) {
+        failed = true;
+        if (onFailure) {
+          onFailure(e);
+        }
+        return;
+      }
+      console.log("Resending chunk " + seq + " of " + key);
+      queue.unshift(seq);
+      fillWindow();
+    });
+  }
+
+  function fillWindow() {
+    while (!failed && inFlight < CHUNK_WINDOW_SIZE && queue.length > 0) {
+      sendChunk(queue.shift());
+    }
   }
 
-  return Math.round(dateObject.getTime() / 1000);
+  console.log("Sending " + key + " in " + count + " chunks of " + chunkSize + " bytes");
+  fillWindow();
+}
+
+// Append a length-prefixed ASCII string to a byte array
+function pushString(bytes, value) {
+  var length = Math.min(value.length, 255);
+  bytes.push(length);
+  for (var i = 0; i < length; i++) {
+    bytes.push(value.charCodeAt(i) & 0xff);
+  }
 }
 
 function processStationData(data) {
   if (!data.payload || data.payload.length === 0) {
     console.log("No stations found");
-    Pebble.sendAppMessage({
-      "ERROR": 1
-    });
+    sendError(ERROR_NO_RESULTS);
     return;
   }
-  
-  var stations = data.payload.slice(0, 8); // Max 8 stations
-  
+
+  var stations = data.payload.slice(0, MAX_STATIONS);
+
   console.log("Processing " + stations.length + " stations");
-  
-  var sendIndex = 0;
-  
-  function sendNextStation() {
-    if (sendIndex >= stations.length) {
-      return;
+
+  // Known stations are sent as their index in the watch's station table; only
+  // stations the watch does not know are followed by their code and name.
+  var bytes = [STATION_LIST_VERSION, stations.length];
+  for (var i = 0; i < stations.length; i++) {
+    var index = stationTable.indexOf(stations[i].code);
+    if (index < 0) {
+      index = STATION_INDEX_UNKNOWN;
+    }
+    bytes.push(index & 0xff, (index >> 8) & 0xff);
+    if (index === STATION_INDEX_UNKNOWN) {
+      pushString(bytes, stations[i].code);
+      pushString(bytes, stations[i].namen.middel);
     }
-    
-    var stationName = stations[sendIndex].namen.middel;
-    var stationCode = stations[sendIndex].code;
-    var currentIndex = sendIndex;
-    
-    
-    Pebble.sendAppMessage({
-      "STATION_INDEX": currentIndex,
-      "STATION_CODE": stationCode,
-      "STATION_NAME": stationName,
-      "STATION_COUNT": stations.length
-    }, function() {
-      console.log("Message sent successfully");
-      sendIndex++;
-      // Wait 20ms before sending next message to avoid buffer overflow
-      setTimeout(sendNextStation, 100);
-    }, function(e) {
-      console.log("Failed to send message: " + e.error.message);
-      sendIndex++;
-      // Retry after a longer delay on error
-      setTimeout(sendNextStation, 200);
-    });
   }
-  
-  sendNextStation();
+
+  sendPayload("STATION_LIST", bytes, function() {
+    console.log("Sent " + stations.length + " stations");
+    syncTimetable();
+  }, function(e) {
+    console.log("Failed to send stations: " + e.error.message);
+  });
 }
 
-function sendRequest(url, sendToWatchFunction){
-  var xhr = new XMLHttpRequest();
-  xhr.timeout = 2000;
+function sendError(code) {
+  Pebble.sendAppMessage({
+    "ERROR": code
+  });
+}
 
-  xhr.open("GET", url, true); // The "true" argument makes it asynchronous.
-  
-  xhr.setRequestHeader("Cache-Control", "no-cache");
-  xhr.setRequestHeader("Ocp-Apim-Subscription-Key", getApiKey());
-  
-  xhr.onload = function() {
-    if (xhr.status >= 200 && xhr.status < 300) {
-      var data;
-      try {
-        data = JSON.parse(xhr.responseText);
-      } catch (e) {
-        console.log("Error parsing JSON response: " + e);
-        Pebble.sendAppMessage({
-          "ERROR": 1
-        });
-        return;
-      }
-      
-      sendToWatchFunction(data);
-    } else {
-      console.log("Did not receive OK. Status: " + xhr.status);
-      Pebble.sendAppMessage({
-        "ERROR": 1
-      });
-    }
-  };
+function errorForFailure(failure) {
+  switch (failure) {
+    case httpClient.FAILURE_AUTH:
+      return ERROR_AUTH;
+    case httpClient.FAILURE_NETWORK:
+      return ERROR_NETWORK;
+    case httpClient.FAILURE_RATE_LIMITED:
+      return ERROR_RATE_LIMITED;
+    default:
+      return ERROR_SERVER;
+  }
+}
 
-  xhr.onerror = function() {
-    console.log("Fetch error: A network error occurred.");
-    Pebble.sendAppMessage({
-      "ERROR": 1
-    });
+// Fetch JSON from the NS API. Failures are reported to the watch as an ERROR
+// unless an onFailure callback handles them instead; it receives one of the
+// httpClient.FAILURE_* classes. Returns a handle whose abort() cancels the
+// request for this caller.
+function sendRequest(url, sendToWatchFunction, onFailure) {
+  var headers = {
+    "Cache-Control": "no-cache",
+    "Ocp-Apim-Subscription-Key": getApiKey()
   };
-  
-  xhr.send();
+  return httpClient.getJson(url, headers, sendToWatchFunction, function(failure) {
+    if (onFailure) {
+      onFailure(failure);
+      return;
+    }
+    sendError(errorForFailure(failure));
+  });
+}
+
+function writeInt32(bytes, offset, value) {
+  bytes[offset] = value & 0xff;
+  bytes[offset + 1] = (value >> 8) & 0xff;
+  bytes[offset + 2] = (value >> 16) & 0xff;
+  bytes[offset + 3] = (value >> 24) & 0xff;
+}
+
+function writeInt16(bytes, offset, value) {
+  bytes[offset] = value & 0xff;
+  bytes[offset + 1] = (value >> 8) & 0xff;
+}
+
+// TRIP_FLAG_* bits of a projected trip
+function tripFlags(trip) {
+  return trip.cancelled ? TRIP_FLAG_CANCELLED : 0;
+}
+
+function writePlatform(bytes, offset, platform) {
+  for (var i = 0; i < TRIP_RECORD_PLATFORM_LENGTH; i++) {
+    bytes[offset + i] = i < platform.length ? platform.charCodeAt(i) & 0xff : 0;
+  }
+}
+
+// Encode one trip (see src/pkjs/trip_model.js) into the fixed-size record
+// layout the watch decodes (see "Trip Record Protocol" in src/c/trein_data.h).
+function encodeTripRecord(bytes, offset, trip) {
+  writeInt32(bytes, offset + 0, trip.departure);
+  writeInt32(bytes, offset + 4, trip.plannedDeparture);
+  writeInt32(bytes, offset + 8, trip.plannedArrival);
+  writeInt32(bytes, offset + 12, trip.arrival);
+  writeInt16(bytes, offset + 16, trip.delay);
+  bytes[offset + 18] = Math.min(trip.transfers, 255);
+  bytes[offset + 19] = tripFlags(trip);
+  writePlatform(bytes, offset + 20, trip.platform);
 }
 
-function processTripData(data) {
-  if (!data.trips || data.trips.length === 0) {
+function processTripData(trips, start, destination) {
+  if (trips.length === 0) {
     console.log("No trips found");
-    Pebble.sendAppMessage({
-      "ERROR": 1
-    });
+    sendError(ERROR_NO_RESULTS);
     return;
   }
-  
 
-  var trips = data.trips.slice(0, 5); // Max 5 trips
-  
-  
-  // Send each trip to the watch with a delay to avoid buffer overflow
-  var sendIndex = 0;
-  
-  function sendNextTrip() {
-    if (sendIndex >= trips.length) {
+  // All trips go to the watch in a single TRIP_DATA byte array
+  var bytes = new Array(TRIP_RECORD_HEADER_SIZE + trips.length * TRIP_RECORD_SIZE);
+  bytes[0] = TRIP_RECORD_VERSION;
+  bytes[1] = trips.length;
+  for (var i = 0; i < trips.length; i++) {
+    encodeTripRecord(bytes, TRIP_RECORD_HEADER_SIZE + i * TRIP_RECORD_SIZE, trips[i]);
+  }
+
+  sendPayload("TRIP_DATA", bytes, function() {
+    console.log("Sent " + trips.length + " trips");
+  }, function(e) {
+    console.log("Failed to send trips: " + e.error.message);
+  });
+
+  startLiveUpdates(start, destination, trips);
+}
+
+// --- Live updates ---
+// While the countdown is open the selected trip is re-polled, more often as
+// its departure gets closer, and only fields that changed are sent to the
+// watch as a TRIP_DELTA (see "Trip Delta Protocol" in src/c/trein_data.h).
+var liveSession = null;
+
+function liveUpdateInterval(secondsLeft) {
+  if (secondsLeft > 60 * 60) {
+    return 10 * 60 * 1000;
+  }
+  if (secondsLeft > 20 * 60) {
+    return 3 * 60 * 1000;
+  }
+  if (secondsLeft > 5 * 60) {
+    return 60 * 1000;
+  }
+  return 30 * 1000;
+}
+
+function startLiveUpdates(start, destination, trips) {
+  stopLiveUpdates();
+
+  var now = Date.now() / 1000;
+  var selected = 0;
+  while (selected < trips.length - 1 && trips[selected].departure <= now) {
+    selected++;
+  }
+
+  liveSession = {
+    start: start,
+    destination: destination,
+    trips: trips,
+    selected: selected,
+    timer: null,
+    request: null
+  };
+  scheduleLiveUpdate();
+}
+
+function stopLiveUpdates() {
+  if (liveSession && liveSession.timer) {
+    clearTimeout(liveSession.timer);
+  }
+  if (liveSession && liveSession.request) {
+    liveSession.request.abort();
+  }
+  liveSession = null;
+}
+
+function selectLiveTrip(index) {
+  if (!liveSession) {
+    return;
+  }
+  if (index < 0 || index >= liveSession.trips.length) {
+    stopLiveUpdates();
+    return;
+  }
+  liveSession.selected = index;
+  scheduleLiveUpdate();
+}
+
+function scheduleLiveUpdate() {
+  if (liveSession.timer) {
+    clearTimeout(liveSession.timer);
+    liveSession.timer = null;
+  }
+
+  var secondsLeft = liveSession.trips[liveSession.selected].departure - Date.now() / 1000;
+  if (secondsLeft <= 0) {
+    console.log("Selected train has left, stopping live updates");
+    stopLiveUpdates();
+    return;
+  }
+  liveSession.timer = setTimeout(pollLiveTrip, liveUpdateInterval(secondsLeft));
+}
+
+function pollLiveTrip() {
+  var session = liveSession;
+  session.timer = null;
+  session.request = fetchTrips(session.start, session.destination, function(trips) {
+    session.request = null;
+    if (session !== liveSession) {
       return;
     }
-    
-    var actualDepartureTime = trips[sendIndex].legs[0].origin.actualDateTime;
-    var plannedDepartureTime = trips[sendIndex].legs[0].origin.plannedDateTime;
-    var actualArrivalTime = trips[sendIndex].legs[trips[sendIndex].transfers].destination.actualDateTime;
-    var plannedArrivalTime = trips[sendIndex].legs[trips[sendIndex].transfers].destination.plannedDateTime;
-    if (actualDepartureTime === undefined) {
-      tripDelay = "Cancelled";
-      actualDepartureTime = trips[sendIndex].legs[trips[sendIndex].transfers].destination.plannedDateTime;
+    sendTripDelta(trips);
+    scheduleLiveUpdate();
+  }, function() {
+    // Keep the current data and try again on the next interval
+    session.request = null;
+    if (session === liveSession) {
+      scheduleLiveUpdate();
     }
+  });
+}
 
-    var delay = (Date.parse(actualDepartureTime)-Date.parse(plannedDepartureTime))/60000;
-    var tripDelay = "On time";
-    if (delay > 0) {
-      tripDelay = "+" + delay;
-    }    
+// Diff the selected trip against freshly fetched trips and send the changed
+// fields
+function sendTripDelta(trips) {
+  var index = liveSession.selected;
+  var current = liveSession.trips[index];
+  var fresh = null;
 
-    if (trips[sendIndex].status == "CANCELLED") {
-      actualDepartureTime = plannedDepartureTime;
-      tripDelay = "Cancelled";
-      actualArrivalTime = "--:--";
-    }
-    
-    if (actualDepartureTime == undefined){
-      console.log('Actual departure time is undefined, value gotten from NS API is:');
-      console.log(trips[sendIndex].legs[0].origin.actualDepartureTime);
+  for (var i = 0; i < trips.length && !fresh; i++) {
+    if (trips[i].plannedDeparture === current.plannedDeparture) {
+      fresh = trips[i];
     }
-    
-    var departurePlatform = trips[sendIndex].legs[0].origin.actualTrack;
-    var tripTransfers = trips[sendIndex].transfers;
-    var currentIndex = sendIndex;
-    var actualDepartureTimeEpoch = convertIsoDateToEpoch(actualDepartureTime);
+  }
+  if (!fresh) {
+    return;
+  }
 
+  var mask = 0;
+  var bytes = [TRIP_DELTA_VERSION, index, 0];
+  if (fresh.delay !== current.delay) {
+    mask |= TRIP_DELTA_DELAY;
+    writeInt16(bytes, bytes.length, fresh.delay);
+  }
+  if (fresh.platform !== current.platform) {
+    mask |= TRIP_DELTA_PLATFORM;
+    writePlatform(bytes, bytes.length, fresh.platform);
+  }
+  if (fresh.departure !== current.departure) {
+    mask |= TRIP_DELTA_DEPARTURE;
+    writeInt32(bytes, bytes.length, fresh.departure);
+  }
+  if (tripFlags(fresh) !== tripFlags(current)) {
+    mask |= TRIP_DELTA_FLAGS;
+    bytes.push(tripFlags(fresh));
+  }
 
-    Pebble.sendAppMessage({
-      "TRIP_INDEX": currentIndex,
-      "TRIP_PLANNED_DEPARTURE_TIME": plannedDepartureTime,
-      "TRIP_DEPARTURE_TIME_EPOCH": actualDepartureTimeEpoch,
-      "TRIP_PLANNED_ARRIVAL_TIME": plannedArrivalTime,
-      "TRIP_ARRIVAL_TIME": actualArrivalTime,
-      "TRIP_TRANSFERS": tripTransfers,
-      "TRIP_PLATFORM": departurePlatform,
-      "TRIP_DELAY": tripDelay,
-      "TRIP_COUNT": trips.length
-    }, function() {
-      sendIndex++;
-      // Wait 100ms before sending next message to avoid buffer overflow
-      setTimeout(sendNextTrip, 100);
-    }, function(e) {
-      console.log("Failed to send message: " + e.error.message);
-      sendIndex++;
-      // Retry after a longer delay on error
-      setTimeout(sendNextTrip, 200);
-    });
+  liveSession.trips[index] = fresh;
+  if (mask === 0) {
+    return;
   }
-  
-  sendNextTrip();
+  bytes[2] = mask;
+
+  Pebble.sendAppMessage({
+    "TRIP_DELTA": bytes
+  }, function() {
+    console.log("Sent delta " + mask + " for trip " + index);
+  }, function(e) {
+    console.log("Failed to send trip delta: " + e.error.message);
+  });
 }
 
+// The station request in flight, replaced when a newer location comes in
+var stationRequest = null;
+
 function fetchNearbyStations(lat, lng) {
-  var url = BASE_API_URL + NEAREST_STATIONS_PATH + "?lat=" + lat + "&lng=" + lng + "&limit=8&includeNonPlannableStations=false";
-  sendRequest(url, processStationData);
+  if (stationRequest) {
+    stationRequest.abort();
+    stationRequest = null;
+  }
+
+  var cached = stationCache.get(lat, lng);
+  if (cached) {
+    console.log("Using cached nearby stations");
+    processStationData({ payload: cached });
+    return;
+  }
+
+  var url = getBaseApiUrl() + NEAREST_STATIONS_PATH + "?lat=" + lat + "&lng=" + lng + "&limit=8&includeNonPlannableStations=false";
+  stationRequest = sendRequest(url, function(data) {
+    stationRequest = null;
+    if (data.payload && data.payload.length > 0) {
+      // Only keep the fields processStationData uses
+      stationCache.put(lat, lng, data.payload.slice(0, MAX_STATIONS).map(function(station) {
+        return { code: station.code, namen: { middel: station.namen.middel } };
+      }));
+    }
+    processStationData(data);
+  }, function(failure) {
+    stationRequest = null;
+    sendError(errorForFailure(failure));
+  });
 }
 
-function requestTrips(start, destination) {
+// The time is rounded down to the minute, so requests for the same route in
+// the same minute share a URL and are answered by one API call. Only the next
+// MAX_TRIPS trips are asked for, without earlier trips or passing stops.
+function tripsUrl(start, destination) {
   const date_now = new Date();
-  var url = BASE_API_URL + TRIP_PATH + "?fromStation=" + start + "&toStation=" + destination + "&dateTime=" + date_now.toISOString();
-  sendRequest(url, processTripData);
+  date_now.setSeconds(0, 0);
+  return getBaseApiUrl() + TRIP_PATH + "?fromStation=" + start + "&toStation=" + destination + "&dateTime=" + date_now.toISOString() +
+    "&previousAdvices=0&nextAdvices=" + MAX_TRIPS + "&passing=false";
+}
+
+// Fetch trips for a route and hand onSuccess their compact model (see
+// src/pkjs/trip_model.js). Returns the request's abort handle.
+function fetchTrips(start, destination, onSuccess, onFailure) {
+  return sendRequest(tripsUrl(start, destination), function(data) {
+    onSuccess(tripModel.project(data, MAX_TRIPS));
+  }, onFailure);
+}
+
+tripPrefetch.init(fetchTrips);
+
+function handlePrefetchHint(start, bytes) {
+  if (bytes[0] !== PREFETCH_HINT_VERSION) {
+    return;
+  }
+  var destinations = [];
+  for (var i = 0; i < bytes[1]; i++) {
+    var offset = PREFETCH_HINT_HEADER_SIZE + i * 2;
+    var code = stationTable.codeAt(bytes[offset] | (bytes[offset + 1] << 8));
+    if (code) {
+      destinations.push(code);
+    }
+  }
+  tripPrefetch.hint(start, destinations);
+}
+
+// The route the watch asked for last. A newer selection supersedes it: its
+// request is aborted and a late answer for it is ignored.
+var tripRequest = null;
+
+function requestTrips(start, destination) {
+  if (tripRequest && tripRequest.handle) {
+    tripRequest.handle.abort();
+  }
+  var request = { handle: null };
+  tripRequest = request;
+
+  function onData(trips) {
+    if (request !== tripRequest) {
+      return;
+    }
+    tripRequest = null;
+    processTripData(trips, start, destination);
+  }
+  function onFailure(failure) {
+    if (request !== tripRequest) {
+      return;
+    }
+    tripRequest = null;
+    sendError(errorForFailure(failure));
+  }
+  function fetchNow() {
+    if (request !== tripRequest) {
+      return;
+    }
+    request.handle = fetchTrips(start, destination, onData, onFailure);
+  }
+
+  tripPrefetch.recordUse(start, destination);
+  var prefetched = tripPrefetch.take(start, destination, onData, fetchNow);
+  if (prefetched) {
+    console.log("Using prefetched trips");
+    // A prefetch still in flight is aborted like any other request
+    if (request === tripRequest) {
+      request.handle = prefetched;
+    }
+    return;
+  }
+  fetchNow();
 }
\ No newline at end of file
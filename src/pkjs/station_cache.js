@@ -0,0 +1,124 @@
+//
+// * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+// * Copyright (c) 2025 Guus Beckett.
+// * 
+// * This program is free software: you can redistribute it and/or modify  
+// * it under the terms of the GNU General Public License as published by  
+// * the Free Software Foundation, version 3.
+// *
+// * This program is distributed in the hope that it will be useful, but 
+// * WITHOUT ANY WARRANTY; without even the implied warranty of 
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+// * General Public License for more details.
+// *
+// * You should have received a copy of the GNU General Public License 
+// * along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// Nearby-station cache in localStorage, keyed by a coarse geohash of the
+// position. Entries expire after CACHE_TTL_MS and the least recently used entry
+// is evicted once the cache holds MAX_ENTRIES positions.
+var STORAGE_KEY = "station_cache";
+var GEOHASH_PRECISION = 6;  // Cells of about 1.2 x 0.6 km
+var CACHE_TTL_MS = 7 * 24 * 60 * 60 * 1000;
+var MAX_ENTRIES = 20;
+
+var BASE32 = "0123456789bcdefghjkmnpqrstuvwxyz";
+
+function geohash(lat, lng, precision) {
+  var latRange = [-90, 90];
+  var lngRange = [-180, 180];
+  var hash = "";
+  var bits = 0;
+  var bitCount = 0;
+  var evenBit = true;
+
+  while (hash.length < precision) {
+    var range = evenBit ? lngRange : latRange;
+    var value = evenBit ? lng : lat;
+    var mid = (range[0] + range[1]) / 2;
+    bits <<= 1;
+    if (value >= mid) {
+      bits |= 1;
+      range[0] = mid;
+    } else {
+      range[1] = mid;
+    }
+    evenBit = !evenBit;
+
+    if (++bitCount === 5) {
+      hash += BASE32.charAt(bits);
+      bits = 0;
+      bitCount = 0;
+    }
+  }
+  return hash;
+}
+
+function load() {
+  try {
+    var stored = localStorage.getItem(STORAGE_KEY);
+    if (stored) {
+      return JSON.parse(stored);
+    }
+  } catch (e) {
+    console.log("Error reading station cache: " + e);
+  }
+  return {};
+}
+
+function save(cache) {
+  try {
+    localStorage.setItem(STORAGE_KEY, JSON.stringify(cache));
+  } catch (e) {
+    console.log("Error writing station cache: " + e);
+  }
+}
+
+// Returns the cached stations near a position, or null on a miss or when the
+// entry has expired
+function get(lat, lng) {
+  var key = geohash(lat, lng, GEOHASH_PRECISION);
+  var cache = load();
+  var entry = cache[key];
+  var now = Date.now();
+
+  if (!entry) {
+    return null;
+  }
+  if (now - entry.savedAt > CACHE_TTL_MS) {
+    delete cache[key];
+    save(cache);
+    return null;
+  }
+
+  entry.usedAt = now;
+  save(cache);
+  return entry.stations;
+}
+
+function put(lat, lng, stations) {
+  var key = geohash(lat, lng, GEOHASH_PRECISION);
+  var cache = load();
+  var now = Date.now();
+
+  cache[key] = { savedAt: now, usedAt: now, stations: stations };
+
+  var keys = Object.keys(cache);
+  while (keys.length > MAX_ENTRIES) {
+    var oldest = keys[0];
+    for (var i = 1; i < keys.length; i++) {
+      if (cache[keys[i]].usedAt < cache[oldest].usedAt) {
+        oldest = keys[i];
+      }
+    }
+    delete cache[oldest];
+    keys = Object.keys(cache);
+  }
+  save(cache);
+}
+
+module.exports = {
+  geohash: geohash,
+  get: get,
+  put: put
+};
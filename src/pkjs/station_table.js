@@ -0,0 +1,73 @@
+//
+// * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+// * Copyright (c) 2025 Guus Beckett.
+// * 
+// * This program is free software: you can redistribute it and/or modify  
+// * it under the terms of the GNU General Public License as published by  
+// * the Free Software Foundation, version 3.
+// *
+// * This program is distributed in the hope that it will be useful, but 
+// * WITHOUT ANY WARRANTY; without even the implied warranty of 
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+// * General Public License for more details.
+// *
+// * You should have received a copy of the GNU General Public License 
+// * along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// The watch's station table (all_stations) is generated from stations.json by
+// tools/generate_stations.py. The watch receives nearby stations as indices
+// into that table, so the phone rebuilds the same order here.
+var stations = require("./stations.json");
+
+var ARTICLES = ["De ", "'t "];
+
+// Same key as sort_key() in tools/generate_stations.py, keep the two in sync
+function sortKey(station) {
+  var name = station.name;
+  for (var i = 0; i < ARTICLES.length; i++) {
+    if (name.indexOf(ARTICLES[i]) === 0) {
+      name = name.substring(ARTICLES[i].length);
+      break;
+    }
+  }
+  return [name.toLowerCase(), station.name.toLowerCase(), station.code];
+}
+
+function compareStations(a, b) {
+  var keyA = sortKey(a);
+  var keyB = sortKey(b);
+  for (var i = 0; i < keyA.length; i++) {
+    if (keyA[i] < keyB[i]) {
+      return -1;
+    }
+    if (keyA[i] > keyB[i]) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+var sortedStations = stations.slice().sort(compareStations);
+var indexByCode = {};
+for (var i = 0; i < sortedStations.length; i++) {
+  indexByCode[sortedStations[i].code] = i;
+}
+
+// Returns the all_stations index for a station code, or -1 if the watch does
+// not know the station.
+function indexOf(code) {
+  var index = indexByCode[code];
+  return index === undefined ? -1 : index;
+}
+
+// Returns the station code for an all_stations index, or null if it is out
+// of range.
+function codeAt(index) {
+  var station = sortedStations[index];
+  return station ? station.code : null;
+}
+
+module.exports = {
+  indexOf: indexOf,
+  codeAt: codeAt
+};
@@ -0,0 +1,306 @@
+//
+// * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+// * Copyright (c) 2025 Guus Beckett.
+// * 
+// * This program is free software: you can redistribute it and/or modify  
+// * it under the terms of the GNU General Public License as published by  
+// * the Free Software Foundation, version 3.
+// *
+// * This program is distributed in the hope that it will be useful, but 
+// * WITHOUT ANY WARRANTY; without even the implied warranty of 
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+// * General Public License for more details.
+// *
+// * You should have received a copy of the GNU General Public License 
+// * along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// Routes for the offline timetable, entered on the settings page with one
+// service per line:
+//
+//   BD UT Mon-Fri 06:14-22:44/30 62m p8 t1
+//   BD UT Sat,Sun 08:14,09:14 62m
+//
+// Station codes, then optionally the days (Mon-Sun if left out), then either
+// a first and last departure every N minutes or a list of departures, then
+// optionally the duration ("62m"), platform ("p8") and transfers ("t1").
+// Lines starting with "#" are ignored. The routes are packed in the same
+// layout as tools/generate_timetable.py (see "Timetable Resource" in
+// src/c/trein_data.h) and stored on the watch. `make -C tests` checks that
+// both give the same bytes for tests/data/timetable.*.
+var stationTable = require("./station_table");
+
+var VERSION = 3;               // TIMETABLE_VERSION in trein_data.h
+var HEADER_SIZE = 4;           // TIMETABLE_HEADER_SIZE
+var ROUTE_SIZE = 12;           // TIMETABLE_ROUTE_SIZE
+var PLATFORM_SIZE = 4;         // TIMETABLE_PLATFORM_SIZE
+var NO_PLATFORM = 0x0f;        // TIMETABLE_NO_PLATFORM
+var MAX_PLATFORMS = NO_PLATFORM;
+var MAX_SERVICES = 16;         // TIMETABLE_MAX_SERVICES
+var MAX_TRANSFERS = 15;
+var MAX_DURATION = 255;
+var MAX_LENGTH = 512;          // TIMETABLE_MAX_SYNCED_LENGTH
+var DAYS = ["Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"];  // Bit 0 is Sunday
+
+var DAYS_PATTERN = /^[A-Za-z]{3}([-,][A-Za-z]{3})*$/;
+var EVERY_PATTERN = /^(\d{1,2}:\d{2})-(\d{1,2}:\d{2})\/(\d+)$/;
+var TIMES_PATTERN = /^\d{1,2}:\d{2}(,\d{1,2}:\d{2})*$/;
+
+// Same as parse_days() in tools/generate_timetable.py, or -1 if invalid
+function parseDays(spec) {
+  var mask = 0;
+  var parts = spec.split(",");
+  for (var i = 0; i < parts.length; i++) {
+    var ends = parts[i].split("-");
+    var first = DAYS.indexOf(ends[0]);
+    var last = DAYS.indexOf(ends[ends.length - 1]);
+    if (ends.length > 2 || first < 0 || last < 0) {
+      return -1;
+    }
+    for (var day = first; ; day = (day + 1) % 7) {
+      mask |= 1 << day;
+      if (day === last) {
+        break;
+      }
+    }
+  }
+  return mask;
+}
+
+// Minutes since midnight, or -1 if invalid
+function parseTime(value) {
+  var parts = value.split(":");
+  var hours = parseInt(parts[0], 10);
+  var minutes = parseInt(parts[1], 10);
+  if (!(hours >= 0 && hours < 24 && minutes >= 0 && minutes < 60)) {
+    return -1;
+  }
+  return hours * 60 + minutes;
+}
+
+function parseDepartures(token) {
+  var departures = [];
+  var every = EVERY_PATTERN.exec(token);
+  if (every) {
+    var first = parseTime(every[1]);
+    var last = parseTime(every[2]);
+    var step = parseInt(every[3], 10);
+    if (first < 0 || last < first || step <= 0) {
+      return null;
+    }
+    for (var minute = first; minute <= last; minute += step) {
+      departures.push(minute);
+    }
+    return departures;
+  }
+  var times = token.split(",");
+  for (var i = 0; i < times.length; i++) {
+    var time = parseTime(times[i]);
+    if (time < 0) {
+      return null;
+    }
+    departures.push(time);
+  }
+  return departures;
+}
+
+// One line to a service, or a string saying what is wrong with it
+function parseService(line) {
+  var tokens = line.split(/\s+/);
+  if (tokens.length < 3) {
+    return "expected stations and departures";
+  }
+  var service = {
+    from: tokens[0].toUpperCase(),
+    to: tokens[1].toUpperCase(),
+    days: parseDays("Mon-Sun"),
+    departures: null,
+    duration: 0,
+    transfers: 0,
+    platform: null
+  };
+  for (var i = 2; i < tokens.length; i++) {
+    var token = tokens[i];
+    var match;
+    if (EVERY_PATTERN.test(token) || TIMES_PATTERN.test(token)) {
+      service.departures = parseDepartures(token);
+      if (!service.departures) {
+        return "invalid departures " + token;
+      }
+    } else if (DAYS_PATTERN.test(token)) {
+      service.days = parseDays(token);
+      if (service.days < 0) {
+        return "invalid days " + token;
+      }
+    } else if ((match = /^(\d+)m$/.exec(token))) {
+      service.duration = parseInt(match[1], 10);
+      if (service.duration > MAX_DURATION) {
+        return "duration over " + MAX_DURATION + " minutes";
+      }
+    } else if ((match = /^t(\d+)$/.exec(token))) {
+      service.transfers = parseInt(match[1], 10);
+      if (service.transfers > MAX_TRANSFERS) {
+        return "more than " + MAX_TRANSFERS + " transfers";
+      }
+    } else if ((match = /^p([\x21-\x7e]{1,4})$/.exec(token))) {
+      service.platform = match[1];
+    } else {
+      return "unknown " + token;
+    }
+  }
+  if (!service.departures) {
+    return "no departures";
+  }
+  return service;
+}
+
+// Group the services per route, in the order the routes first appear
+function parseRoutes(text, errors) {
+  var routes = [];
+  var byKey = {};
+  var lines = text.split(/\r?\n/);
+  for (var i = 0; i < lines.length; i++) {
+    var line = lines[i].trim();
+    if (!line || line.charAt(0) === "#") {
+      continue;
+    }
+    var service = parseService(line);
+    if (typeof service === "string") {
+      errors.push("Line " + (i + 1) + ": " + service);
+      continue;
+    }
+    var from = stationTable.indexOf(service.from);
+    var to = stationTable.indexOf(service.to);
+    if (from < 0 || to < 0) {
+      errors.push("Line " + (i + 1) + ": unknown station " + (from < 0 ? service.from : service.to));
+      continue;
+    }
+    var key = service.from + " " + service.to;
+    if (!byKey[key]) {
+      byKey[key] = { from: from, to: to, name: key, services: [] };
+      routes.push(byKey[key]);
+    }
+    byKey[key].services.push(service);
+  }
+  return routes;
+}
+
+// Same as pack_route() in tools/generate_timetable.py: the route's block and
+// its departure and platform counts, or a string if it does not fit
+function packRoute(route) {
+  // Platforms and services are numbered in the order they first appear
+  var platforms = [];
+  var services = [];
+  var departures = [];
+  for (var i = 0; i < route.services.length; i++) {
+    var service = route.services[i];
+    var platformIndex = NO_PLATFORM;
+    if (service.platform !== null) {
+      platformIndex = platforms.indexOf(service.platform);
+      if (platformIndex < 0) {
+        platformIndex = platforms.push(service.platform) - 1;
+      }
+      if (platformIndex >= MAX_PLATFORMS) {
+        return "more than " + MAX_PLATFORMS + " platforms";
+      }
+    }
+    var packed = [service.days, service.duration, service.transfers << 4 | platformIndex];
+    var serviceIndex = -1;
+    for (var k = 0; k < services.length && serviceIndex < 0; k++) {
+      if (services[k].join() === packed.join()) {
+        serviceIndex = k;
+      }
+    }
+    if (serviceIndex < 0) {
+      serviceIndex = services.push(packed) - 1;
+    }
+    if (serviceIndex >= MAX_SERVICES) {
+      return "more than " + MAX_SERVICES + " services";
+    }
+    for (var j = 0; j < service.departures.length; j++) {
+      departures.push([service.departures[j], serviceIndex]);
+    }
+  }
+  departures.sort(function(a, b) {
+    return (a[0] - b[0]) || (a[1] - b[1]);
+  });
+
+  var block = [];
+  for (i = 0; i < platforms.length; i++) {
+    for (j = 0; j < PLATFORM_SIZE; j++) {
+      block.push(j < platforms[i].length ? platforms[i].charCodeAt(j) : 0);
+    }
+  }
+  for (i = 0; i < services.length; i++) {
+    Array.prototype.push.apply(block, services[i]);
+  }
+  var next = 0;
+  for (var hour = 0; hour <= 24; hour++) {
+    while (next < departures.length && departures[next][0] < hour * 60) {
+      next++;
+    }
+    block.push(next & 0xff, next >> 8);
+  }
+  for (i = 0; i < departures.length; i++) {
+    block.push(departures[i][0] % 60, departures[i][1]);
+  }
+  return {
+    block: block,
+    departureCount: departures.length,
+    platformCount: platforms.length,
+    serviceCount: services.length
+  };
+}
+
+function pushUint16(bytes, value) {
+  bytes.push(value & 0xff, (value >> 8) & 0xff);
+}
+
+function packRoutes(packed) {
+  var bytes = [0x54, 0x54, VERSION, packed.length];  // "TT"
+  var offset = HEADER_SIZE + ROUTE_SIZE * packed.length;
+  var i;
+  for (i = 0; i < packed.length; i++) {
+    pushUint16(bytes, packed[i].from);
+    pushUint16(bytes, packed[i].to);
+    pushUint16(bytes, offset & 0xffff);
+    pushUint16(bytes, offset >> 16);
+    pushUint16(bytes, packed[i].departureCount);
+    bytes.push(packed[i].platformCount, packed[i].serviceCount);
+    offset += packed[i].block.length;
+  }
+  for (i = 0; i < packed.length; i++) {
+    Array.prototype.push.apply(bytes, packed[i].block);
+  }
+  return bytes;
+}
+
+// Parse the settings text and pack it for the watch. Lines that cannot be
+// read and routes that no longer fit in MAX_LENGTH bytes are left out and
+// described in errors. An empty text packs to a timetable without routes,
+// which clears the one on the watch.
+function compile(text) {
+  var errors = [];
+  var routes = parseRoutes(text || "", errors);
+  var packed = [];
+  var length = HEADER_SIZE;
+  for (var i = 0; i < routes.length && packed.length < 255; i++) {
+    var route = packRoute(routes[i]);
+    if (typeof route === "string") {
+      errors.push(routes[i].name + ": " + route);
+      continue;
+    }
+    if (length + ROUTE_SIZE + route.block.length > MAX_LENGTH) {
+      errors.push(routes[i].name + ": does not fit on the watch");
+      continue;
+    }
+    route.from = routes[i].from;
+    route.to = routes[i].to;
+    length += ROUTE_SIZE + route.block.length;
+    packed.push(route);
+  }
+  return { bytes: packRoutes(packed), routeCount: packed.length, errors: errors };
+}
+
+module.exports = {
+  compile: compile
+};
@@ -0,0 +1,104 @@
+//
+// * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+// * Copyright (c) 2025 Guus Beckett.
+// * 
+// * This program is free software: you can redistribute it and/or modify  
+// * it under the terms of the GNU General Public License as published by  
+// * the Free Software Foundation, version 3.
+// *
+// * This program is distributed in the hope that it will be useful, but 
+// * WITHOUT ANY WARRANTY; without even the implied warranty of 
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+// * General Public License for more details.
+// *
+// * You should have received a copy of the GNU General Public License 
+// * along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// Compact model of a trips response. project() is the only place that reads
+// the NS API's trip objects; everything after it works on these fields:
+//
+//   departure, plannedDeparture  epoch seconds of the first leg's departure
+//   arrival, plannedArrival      epoch seconds of the last leg's arrival, 0 if unknown
+//   delay                        departure delay in whole minutes
+//   platform                     departure track, "" if unknown
+//   transfers                    number of changes
+//   status                       the API's trip status, e.g. "NORMAL" or "CANCELLED"
+//   cancelled                    true if the whole trip is cancelled
+//   legs                         per leg: departure, arrival, platform and cancelled
+
+function convertIsoDateToEpoch(apiDateString) {
+  if (!apiDateString || typeof apiDateString !== 'string') {
+    return 0;
+  }
+
+  let compliantString = apiDateString.slice(0, -2) + ":" + apiDateString.slice(-2);
+  
+  let dateObject = new Date(compliantString);
+  
+  if (isNaN(dateObject)) {
+    return 0;
+  }
+
+  return Math.round(dateObject.getTime() / 1000);
+}
+
+function projectLeg(leg) {
+  return {
+    departure: convertIsoDateToEpoch(leg.origin.actualDateTime || leg.origin.plannedDateTime),
+    arrival: convertIsoDateToEpoch(leg.destination.actualDateTime || leg.destination.plannedDateTime),
+    platform: leg.origin.actualTrack || leg.origin.plannedTrack || "",
+    cancelled: leg.cancelled === true
+  };
+}
+
+// Reduce one NS trip to the fields the watch shows, with times as epochs
+function projectTrip(trip) {
+  var firstLeg = trip.legs[0];
+  var lastLeg = trip.legs[trip.legs.length - 1];
+
+  var plannedDepartureTime = firstLeg.origin.plannedDateTime;
+  var actualDepartureTime = firstLeg.origin.actualDateTime || plannedDepartureTime;
+  var plannedArrivalTime = lastLeg.destination.plannedDateTime;
+  var actualArrivalTime = lastLeg.destination.actualDateTime || plannedArrivalTime;
+
+  var cancelled = trip.status == "CANCELLED";
+  if (cancelled) {
+    actualDepartureTime = plannedDepartureTime;
+    actualArrivalTime = undefined;
+  }
+
+  var delay = Math.round((Date.parse(actualDepartureTime) - Date.parse(plannedDepartureTime)) / 60000);
+  if (isNaN(delay)) {
+    delay = 0;
+  }
+
+  return {
+    departure: convertIsoDateToEpoch(actualDepartureTime),
+    plannedDeparture: convertIsoDateToEpoch(plannedDepartureTime),
+    plannedArrival: convertIsoDateToEpoch(plannedArrivalTime),
+    arrival: convertIsoDateToEpoch(actualArrivalTime),
+    delay: delay,
+    platform: firstLeg.origin.actualTrack || firstLeg.origin.plannedTrack || "",
+    transfers: trip.transfers || 0,
+    status: trip.status || "",
+    cancelled: cancelled,
+    legs: trip.legs.map(projectLeg)
+  };
+}
+
+// Project the first `limit` trips of a trips response, skipping trips
+// without legs. Returns an empty array if the response has no trips.
+function project(data, limit) {
+  var trips = [];
+  var apiTrips = (data && data.trips) || [];
+  for (var i = 0; i < apiTrips.length && trips.length < limit; i++) {
+    if (apiTrips[i].legs && apiTrips[i].legs.length > 0) {
+      trips.push(projectTrip(apiTrips[i]));
+    }
+  }
+  return trips;
+}
+
+module.exports = {
+  project: project
+};
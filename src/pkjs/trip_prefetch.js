@@ -0,0 +1,225 @@
+//
+// * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+// * Copyright (c) 2025 Guus Beckett.
+// * 
+// * This program is free software: you can redistribute it and/or modify  
+// * it under the terms of the GNU General Public License as published by  
+// * the Free Software Foundation, version 3.
+// *
+// * This program is distributed in the hope that it will be useful, but 
+// * WITHOUT ANY WARRANTY; without even the implied warranty of 
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+// * General Public License for more details.
+// *
+// * You should have received a copy of the GNU General Public License 
+// * along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// Speculative trip prefetching. While a destination list is open the watch
+// hints the highlighted station and its neighbours; those routes and the
+// destinations most often picked from the same start are fetched ahead of a
+// select and kept in memory for CACHE_TTL_MS. At most MAX_CONCURRENT requests
+// run at once and at most QUOTA_REQUESTS are started per QUOTA_WINDOW_MS, so
+// scrolling through a long list cannot flood the API.
+var CACHE_TTL_MS = 90 * 1000;
+var MAX_CONCURRENT = 2;
+var QUOTA_REQUESTS = 10;
+var QUOTA_WINDOW_MS = 60 * 1000;
+var MOST_USED_COUNT = 2;
+
+var USAGE_STORAGE_KEY = "destination_usage";
+var MAX_USAGE_ENTRIES = 10;  // Destinations remembered per start station
+
+var fetchTrips = null;  // function(start, destination, onSuccess(trips), onFailure)
+var entries = {};       // Route key -> { trips, fetchedAt } or { waiters, request } while in flight
+var queue = [];
+var inFlight = 0;
+var startedAt = [];     // Start times of the requests inside the quota window
+var quotaTimer = null;
+
+function routeKey(start, destination) {
+  return start + ">" + destination;
+}
+
+function loadUsage() {
+  try {
+    var stored = localStorage.getItem(USAGE_STORAGE_KEY);
+    if (stored) {
+      return JSON.parse(stored);
+    }
+  } catch (e) {
+    console.log("Error reading destination usage: " + e);
+  }
+  return {};
+}
+
+function saveUsage(usage) {
+  try {
+    localStorage.setItem(USAGE_STORAGE_KEY, JSON.stringify(usage));
+  } catch (e) {
+    console.log("Error writing destination usage: " + e);
+  }
+}
+
+function mostUsed(start) {
+  var counts = loadUsage()[start] || {};
+  return Object.keys(counts).sort(function(a, b) {
+    return counts[b] - counts[a];
+  }).slice(0, MOST_USED_COUNT);
+}
+
+// Count a selected route, so it is prefetched for this start station later
+function recordUse(start, destination) {
+  var usage = loadUsage();
+  var counts = usage[start] || {};
+  counts[destination] = (counts[destination] || 0) + 1;
+
+  var destinations = Object.keys(counts);
+  while (destinations.length > MAX_USAGE_ENTRIES) {
+    var least = destinations[0];
+    for (var i = 1; i < destinations.length; i++) {
+      if (destinations[i] !== destination && counts[destinations[i]] < counts[least]) {
+        least = destinations[i];
+      }
+    }
+    delete counts[least];
+    destinations = Object.keys(counts);
+  }
+
+  usage[start] = counts;
+  saveUsage(usage);
+}
+
+function isFresh(entry) {
+  return entry.trips && Date.now() - entry.fetchedAt <= CACHE_TTL_MS;
+}
+
+// Requests that may still start inside the quota window
+function quotaLeft() {
+  var now = Date.now();
+  while (startedAt.length > 0 && now - startedAt[0] >= QUOTA_WINDOW_MS) {
+    startedAt.shift();
+  }
+  return QUOTA_REQUESTS - startedAt.length;
+}
+
+function start(route) {
+  var key = routeKey(route.start, route.destination);
+  var entry = { waiters: [] };
+  entries[key] = entry;
+  inFlight++;
+  startedAt.push(Date.now());
+
+  entry.request = fetchTrips(route.start, route.destination, function(trips) {
+    inFlight--;
+    entries[key] = { trips: trips, fetchedAt: Date.now() };
+    entry.waiters.forEach(function(waiter) {
+      waiter.onData(trips);
+    });
+    pump();
+  }, function() {
+    inFlight--;
+    delete entries[key];
+    entry.waiters.forEach(function(waiter) {
+      waiter.onFailure();
+    });
+    pump();
+  });
+}
+
+function pump() {
+  while (queue.length > 0 && inFlight < MAX_CONCURRENT) {
+    if (quotaLeft() <= 0) {
+      // Try again once the oldest request leaves the window
+      if (!quotaTimer) {
+        quotaTimer = setTimeout(function() {
+          quotaTimer = null;
+          pump();
+        }, QUOTA_WINDOW_MS - (Date.now() - startedAt[0]));
+      }
+      return;
+    }
+    start(queue.shift());
+  }
+}
+
+// Replace the queued prefetches with the hinted destinations, in order of
+// priority, followed by the start station's most used destinations
+function hint(startCode, destinations) {
+  Object.keys(entries).forEach(function(key) {
+    if (!entries[key].waiters && !isFresh(entries[key])) {
+      delete entries[key];
+    }
+  });
+
+  var candidates = destinations.concat(mostUsed(startCode));
+  queue = [];
+  for (var i = 0; i < candidates.length; i++) {
+    var destination = candidates[i];
+    var entry = entries[routeKey(startCode, destination)];
+    if (destination === startCode || (entry && (entry.waiters || isFresh(entry)))) {
+      continue;
+    }
+    if (queue.some(function(route) { return route.destination === destination; })) {
+      continue;
+    }
+    queue.push({ start: startCode, destination: destination });
+  }
+  pump();
+}
+
+// Stop waiting for a prefetch in flight. Once nobody waits for it anymore
+// the request itself is aborted, freeing its slot for the queue.
+function leave(key, entry, waiter) {
+  var index = entry.waiters.indexOf(waiter);
+  if (index < 0) {
+    return;
+  }
+  entry.waiters.splice(index, 1);
+  if (entry.waiters.length === 0 && entries[key] === entry) {
+    entry.request.abort();
+    delete entries[key];
+    inFlight--;
+    pump();
+  }
+}
+
+// Hand over prefetched trips for a route. Returns null if the route has to be
+// fetched normally. Otherwise onData is called now or when the prefetch in
+// flight completes, onFailure if that prefetch fails, and the returned handle's
+// abort() drops the interest like an http_client handle.
+function take(startCode, destination, onData, onFailure) {
+  // The user has picked a route, the remaining guesses are not needed
+  queue = [];
+
+  var key = routeKey(startCode, destination);
+  var entry = entries[key];
+  if (!entry) {
+    return null;
+  }
+  if (entry.waiters) {
+    var waiter = { onData: onData, onFailure: onFailure };
+    entry.waiters.push(waiter);
+    return {
+      abort: function() {
+        leave(key, entry, waiter);
+      }
+    };
+  }
+  delete entries[key];
+  if (!isFresh(entry)) {
+    return null;
+  }
+  onData(entry.trips);
+  return { abort: function() {} };
+}
+
+function init(fetch) {
+  fetchTrips = fetch;
+}
+
+module.exports = {
+  init: init,
+  hint: hint,
+  take: take,
+  recordUse: recordUse
+};
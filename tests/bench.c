@@ -0,0 +1,299 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdlib.h>
+#include "payloads.h"
+#include "protocol.h"
+#include "trip_format.h"
+#include "trip_leg.h"
+
+// Microbenchmarks for the watch code that runs on every message, tick and
+// redraw. Each benchmark is timed over batches of at least MIN_BATCH_NS and
+// the best of RUNS is kept, which filters out most scheduling noise.
+//
+//   bench                     print the results
+//   bench --check FILE        also compare them with a baseline, failing when
+//                             one is more than BENCH_TOLERANCE (default 2)
+//                             times worse
+//   bench --write FILE        store the results in the baseline
+//
+// The rect build runs everything, the round build only the round geometry.
+// Units ending in "/s" are rates, higher is better; the rest are costs.
+
+#define RUNS 5
+#define MIN_BATCH_NS 50000000LL
+#define DEFAULT_TOLERANCE 2.0
+#define MAX_BASELINE_ENTRIES 32
+
+typedef struct {
+  const char *name;
+  const char *unit;
+  double value;
+} BenchResult;
+
+typedef struct {
+  char name[48];
+  char unit[16];
+  double value;
+} BaselineEntry;
+
+// Keeps the compiler from dropping the work being measured
+static volatile int s_sink;
+
+static long long prv_now_ns(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return time.tv_sec * 1000000000LL + time.tv_nsec;
+}
+
+// Nanoseconds per call of body(iteration), best of RUNS batches
+static double prv_measure(void (*body)(long iteration)) {
+  long iterations = 1000;
+  long long elapsed;
+  for (;;) {
+    const long long start = prv_now_ns();
+    for (long i = 0; i < iterations; i++) { body(i); }
+    elapsed = prv_now_ns() - start;
+    if (elapsed >= MIN_BATCH_NS) { break; }
+    iterations *= 2;
+  }
+
+  double best = (double)elapsed / iterations;
+  for (int run = 1; run < RUNS; run++) {
+    const long long start = prv_now_ns();
+    for (long i = 0; i < iterations; i++) { body(i); }
+    const double per_call = (double)(prv_now_ns() - start) / iterations;
+    if (per_call < best) { best = per_call; }
+  }
+  return best;
+}
+
+static TripData s_trips;
+static uint8_t s_trip_payload[TRIP_RECORD_HEADER_SIZE + MAX_TRIPS * TRIP_RECORD_SIZE];
+static uint16_t s_trip_payload_length;
+static uint8_t s_station_payload[128];
+static uint16_t s_station_payload_length;
+static uint8_t s_delta_payload[16];
+static uint16_t s_delta_payload_length;
+
+// A full TRIP_DATA, a STATION_LIST with two stations that are not in the
+// table, and a TRIP_DELTA with every field
+static void prv_prepare_payloads(void) {
+  static const char *platforms[] = { "8", "12a", "5", "10ab", "3" };
+  static const char *codes[] = { "BD", "UT", "ASD", "XYZ", "RTD", "GVC", "QQ", "EHV" };
+  static const char *names[] = { "", "", "", "Nowhere", "", "", "Elsewhere", "" };
+
+  memset(&s_trips, 0, sizeof(s_trips));
+  s_trips.count = MAX_TRIPS;
+  for (int i = 0; i < MAX_TRIPS; i++) {
+    s_trips.planned_departures[i] = 1760693400 + i * 1800;
+    s_trips.delays[i] = i;
+    s_trips.departures[i] = s_trips.planned_departures[i] + i * 60;
+    s_trips.planned_arrivals[i] = s_trips.planned_departures[i] + 3720;
+    s_trips.arrivals[i] = s_trips.planned_arrivals[i] + i * 60;
+    s_trips.transfers[i] = i % 3;
+    strcpy(s_trips.platform[i], platforms[i]);
+  }
+  s_trip_payload_length = payload_trip_data(&s_trips, s_trip_payload);
+  s_station_payload_length = payload_station_list(codes, names, ARRAY_LENGTH(codes), s_station_payload);
+  s_delta_payload_length = payload_trip_delta(&s_trips, 2, TRIP_DELTA_DELAY | TRIP_DELTA_PLATFORM |
+                                              TRIP_DELTA_DEPARTURE | TRIP_DELTA_FLAGS, s_delta_payload);
+  s_trips.loaded = true;
+}
+
+#ifndef PBL_ROUND
+static void prv_decode_trip_data(long iteration) {
+  TripData trips;
+  s_sink += protocol_decode_trip_data(s_trip_payload, s_trip_payload_length, &trips) + trips.count;
+}
+
+static void prv_decode_station_list(long iteration) {
+  StationData stations;
+  s_sink += protocol_decode_station_list(s_station_payload, s_station_payload_length, &stations) + stations.count;
+}
+
+static void prv_apply_trip_delta(long iteration) {
+  int index;
+  s_sink += protocol_apply_trip_delta(s_delta_payload, s_delta_payload_length, &s_trips, &index);
+}
+
+// What the countdown's tick handler formats every second: the clock and the
+// time left until the selected train
+static void prv_format_tick(long iteration) {
+  const time_t now = s_trips.departures[0] - 3600 + iteration % 7200;
+  char clock[8];
+  char countdown[16];
+  strftime(clock, sizeof(clock), "%H:%M", localtime(&now));
+  const int index = trip_format_first_upcoming(&s_trips, now);
+  const int trip = (index < 0) ? 0 : index;
+  s_sink += clock[4] + trip_format_countdown(s_trips.departures[trip], s_trips.flags[trip], now,
+                                             countdown, sizeof(countdown));
+}
+
+// Everything a trip card formats when it is filled in
+static void prv_format_card(long iteration) {
+  const int index = iteration % MAX_TRIPS;
+  char delay[16];
+  char departure[8];
+  char arrival[8];
+  char countdown[16];
+  trip_format_delay(&s_trips, index, delay, sizeof(delay));
+  trip_format_clock_time(s_trips.planned_departures[index], departure, sizeof(departure));
+  trip_format_clock_time(s_trips.planned_arrivals[index], arrival, sizeof(arrival));
+  s_sink += delay[0] + departure[4] + arrival[4] +
+            trip_format_countdown(s_trips.departures[index], 0, s_trips.planned_departures[0], countdown, sizeof(countdown));
+}
+#endif
+
+// A trip-leg redraw: geometry for the shown trip, from the cache on round
+// displays and laid out again on rectangular ones
+static void prv_geometry_redraw(long iteration) {
+  const GRect bounds = PBL_IF_ROUND_ELSE(GRect(0, 0, 180, 180), GRect(0, 0, 144, 168));
+  TripLegGeometry scratch;
+  s_sink += trip_leg_geometry(bounds, iteration % 3, &scratch)->leg_count;
+}
+
+// A redraw that misses the cache and lays out the legs again
+static void prv_geometry_layout(long iteration) {
+  const GRect bounds = PBL_IF_ROUND_ELSE(GRect(0, 0, 180, 180), GRect(0, 0, 144, 168));
+  TripLegGeometry geometry;
+  trip_leg_layout(bounds, iteration % 4, &geometry);
+  s_sink += geometry.dots[0].y;
+}
+
+static int prv_run(BenchResult *results) {
+  int count = 0;
+#ifdef PBL_ROUND
+  results[count++] = (BenchResult){ "geometry_redraw_round", "ns/redraw", prv_measure(prv_geometry_redraw) };
+  results[count++] = (BenchResult){ "geometry_layout_round", "ns/layout", prv_measure(prv_geometry_layout) };
+#else
+  results[count++] = (BenchResult){ "decode_trip_data", "msgs/s", 1e9 / prv_measure(prv_decode_trip_data) };
+  results[count++] = (BenchResult){ "decode_station_list", "msgs/s", 1e9 / prv_measure(prv_decode_station_list) };
+  results[count++] = (BenchResult){ "apply_trip_delta", "msgs/s", 1e9 / prv_measure(prv_apply_trip_delta) };
+  results[count++] = (BenchResult){ "format_tick", "ns/tick", prv_measure(prv_format_tick) };
+  results[count++] = (BenchResult){ "format_card", "ns/card", prv_measure(prv_format_card) };
+  results[count++] = (BenchResult){ "geometry_redraw_rect", "ns/redraw", prv_measure(prv_geometry_redraw) };
+  results[count++] = (BenchResult){ "geometry_layout_rect", "ns/layout", prv_measure(prv_geometry_layout) };
+#endif
+  return count;
+}
+
+static bool prv_is_rate(const char *unit) {
+  const size_t length = strlen(unit);
+  return length >= 2 && strcmp(unit + length - 2, "/s") == 0;
+}
+
+static int prv_read_baseline(const char *path, BaselineEntry *entries) {
+  FILE *file = fopen(path, "r");
+  if (!file) { return 0; }
+  char line[128];
+  int count = 0;
+  while (count < MAX_BASELINE_ENTRIES && fgets(line, sizeof(line), file)) {
+    if (line[0] == '#') { continue; }
+    BaselineEntry *entry = &entries[count];
+    if (sscanf(line, "%47s %lf %15s", entry->name, &entry->value, entry->unit) == 3) { count++; }
+  }
+  fclose(file);
+  return count;
+}
+
+static const BaselineEntry *prv_find(const BaselineEntry *entries, int count, const char *name) {
+  for (int i = 0; i < count; i++) {
+    if (strcmp(entries[i].name, name) == 0) { return &entries[i]; }
+  }
+  return NULL;
+}
+
+// Replace this build's entries in the baseline and keep the others
+static int prv_write_baseline(const char *path, const BenchResult *results, int result_count) {
+  BaselineEntry entries[MAX_BASELINE_ENTRIES];
+  const int count = prv_read_baseline(path, entries);
+  FILE *file = fopen(path, "w");
+  if (!file) {
+    perror(path);
+    return EXIT_FAILURE;
+  }
+  fprintf(file, "# Baseline for tests/bench.c, written by `make -C tests bench-baseline`\n");
+  fprintf(file, "# name value unit\n");
+  for (int i = 0; i < count; i++) {
+    bool replaced = false;
+    for (int j = 0; j < result_count; j++) {
+      replaced |= strcmp(entries[i].name, results[j].name) == 0;
+    }
+    if (!replaced) { fprintf(file, "%s %.4g %s\n", entries[i].name, entries[i].value, entries[i].unit); }
+  }
+  for (int i = 0; i < result_count; i++) {
+    fprintf(file, "%s %.4g %s\n", results[i].name, results[i].value, results[i].unit);
+  }
+  fclose(file);
+  return EXIT_SUCCESS;
+}
+
+// Print the results next to the baseline. Returns the number of regressions.
+static int prv_compare(const BenchResult *results, int count, const char *path) {
+  BaselineEntry entries[MAX_BASELINE_ENTRIES];
+  const int entry_count = path ? prv_read_baseline(path, entries) : 0;
+  const char *tolerance_text = getenv("BENCH_TOLERANCE");
+  const double tolerance = tolerance_text ? atof(tolerance_text) : DEFAULT_TOLERANCE;
+  int regressions = 0;
+
+  for (int i = 0; i < count; i++) {
+    const BenchResult *result = &results[i];
+    const BaselineEntry *baseline = prv_find(entries, entry_count, result->name);
+    printf("%-24s %12.4g %-10s", result->name, result->value, result->unit);
+    if (!baseline) {
+      printf("%s\n", path ? "  no baseline" : "");
+      continue;
+    }
+    // How many times worse than the baseline, below 1 is an improvement
+    const double slowdown = prv_is_rate(result->unit) ? baseline->value / result->value
+                                                      : result->value / baseline->value;
+    const bool regressed = slowdown > tolerance;
+    printf("  baseline %10.4g  %5.2fx%s\n", baseline->value, slowdown, regressed ? "  REGRESSION" : "");
+    regressions += regressed;
+  }
+  return regressions;
+}
+
+int main(int argc, char **argv) {
+  const char *check_path = NULL;
+  const char *write_path = NULL;
+  if (argc == 3 && strcmp(argv[1], "--check") == 0) {
+    check_path = argv[2];
+  } else if (argc == 3 && strcmp(argv[1], "--write") == 0) {
+    write_path = argv[2];
+  } else if (argc != 1) {
+    fprintf(stderr, "Usage: %s [--check FILE | --write FILE]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  setenv("TZ", "Europe/Amsterdam", 1);
+  tzset();
+  prv_prepare_payloads();
+
+  BenchResult results[16];
+  const int count = prv_run(results);
+  if (write_path) {
+    prv_compare(results, count, NULL);
+    return prv_write_baseline(write_path, results, count);
+  }
+  const int regressions = prv_compare(results, count, check_path);
+  if (regressions > 0) {
+    fprintf(stderr, "%d benchmark(s) more than BENCH_TOLERANCE times worse than %s\n", regressions, check_path);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,31 @@
+//
+// * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+// * Copyright (c) 2025 Guus Beckett.
+// * 
+// * This program is free software: you can redistribute it and/or modify  
+// * it under the terms of the GNU General Public License as published by  
+// * the Free Software Foundation, version 3.
+// *
+// * This program is distributed in the hope that it will be useful, but 
+// * WITHOUT ANY WARRANTY; without even the implied warranty of 
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+// * General Public License for more details.
+// *
+// * You should have received a copy of the GNU General Public License 
+// * along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// Packs a timetable in the settings page format with src/pkjs/timetable.js,
+// so the host tests can compare it with tools/generate_timetable.py.
+//
+// Usage: node pack_timetable.js <timetable.txt> <timetable.bin>
+var fs = require("fs");
+var path = require("path");
+var timetable = require(path.join(__dirname, "..", "src", "pkjs", "timetable"));
+
+var result = timetable.compile(fs.readFileSync(process.argv[2], "utf8"));
+if (result.errors.length > 0) {
+  console.error(result.errors.join("\n"));
+  process.exit(1);
+}
+fs.writeFileSync(process.argv[3], Buffer.from(result.bytes));
+console.log("Wrote " + process.argv[3] + " (" + result.bytes.length + " bytes)");
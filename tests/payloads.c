@@ -0,0 +1,90 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "payloads.h"
+#include "stations.h"
+
+static uint8_t *prv_put_int16(uint8_t *out, int16_t value) {
+  out[0] = value & 0xFF;
+  out[1] = (value >> 8) & 0xFF;
+  return out + 2;
+}
+
+static uint8_t *prv_put_int32(uint8_t *out, int32_t value) {
+  for (int i = 0; i < 4; i++) {
+    out[i] = ((uint32_t)value >> (8 * i)) & 0xFF;
+  }
+  return out + 4;
+}
+
+static uint8_t *prv_put_platform(uint8_t *out, const char *platform) {
+  const size_t length = strlen(platform);
+  for (int i = 0; i < TRIP_RECORD_PLATFORM_LENGTH; i++) {
+    out[i] = (i < (int)length) ? platform[i] : '\0';
+  }
+  return out + TRIP_RECORD_PLATFORM_LENGTH;
+}
+
+static uint8_t *prv_put_string(uint8_t *out, const char *string) {
+  const size_t length = strlen(string);
+  out[0] = length;
+  memcpy(out + 1, string, length);
+  return out + 1 + length;
+}
+
+uint16_t payload_trip_data(const TripData *trips, uint8_t *buffer) {
+  buffer[0] = TRIP_RECORD_VERSION;
+  buffer[1] = trips->count;
+  for (int i = 0; i < trips->count; i++) {
+    uint8_t *record = buffer + TRIP_RECORD_HEADER_SIZE + i * TRIP_RECORD_SIZE;
+    prv_put_int32(record + TRIP_RECORD_OFFSET_DEPARTURE, trips->departures[i]);
+    prv_put_int32(record + TRIP_RECORD_OFFSET_PLANNED_DEPARTURE, trips->planned_departures[i]);
+    prv_put_int32(record + TRIP_RECORD_OFFSET_PLANNED_ARRIVAL, trips->planned_arrivals[i]);
+    prv_put_int32(record + TRIP_RECORD_OFFSET_ARRIVAL, trips->arrivals[i]);
+    prv_put_int16(record + TRIP_RECORD_OFFSET_DELAY, trips->delays[i]);
+    record[TRIP_RECORD_OFFSET_TRANSFERS] = trips->transfers[i];
+    record[TRIP_RECORD_OFFSET_FLAGS] = trips->flags[i];
+    prv_put_platform(record + TRIP_RECORD_OFFSET_PLATFORM, trips->platform[i]);
+  }
+  return TRIP_RECORD_HEADER_SIZE + trips->count * TRIP_RECORD_SIZE;
+}
+
+uint16_t payload_station_list(const char *const *codes, const char *const *names, int count, uint8_t *buffer) {
+  uint8_t *out = buffer;
+  *out++ = STATION_LIST_VERSION;
+  *out++ = count;
+  for (int i = 0; i < count; i++) {
+    const int index = station_index_for_code(codes[i]);
+    out = prv_put_int16(out, (index < 0) ? (int16_t)STATION_INDEX_UNKNOWN : index);
+    if (index < 0) {
+      out = prv_put_string(out, codes[i]);
+      out = prv_put_string(out, names[i]);
+    }
+  }
+  return out - buffer;
+}
+
+uint16_t payload_trip_delta(const TripData *trips, int index, uint8_t mask, uint8_t *buffer) {
+  uint8_t *out = buffer;
+  *out++ = TRIP_DELTA_VERSION;
+  *out++ = index;
+  *out++ = mask;
+  if (mask & TRIP_DELTA_DELAY) { out = prv_put_int16(out, trips->delays[index]); }
+  if (mask & TRIP_DELTA_PLATFORM) { out = prv_put_platform(out, trips->platform[index]); }
+  if (mask & TRIP_DELTA_DEPARTURE) { out = prv_put_int32(out, trips->departures[index]); }
+  if (mask & TRIP_DELTA_FLAGS) { *out++ = trips->flags[index]; }
+  return out - buffer;
+}
@@ -0,0 +1,33 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <pebble.h>
+#include "trein_data.h"
+
+// Encoders for the payloads the phone sends, the inverse of protocol.c. They
+// follow src/pkjs/index.js, so tests and benchmarks feed the decoders the
+// same bytes a watch would receive. Each returns the payload length.
+
+// TRIP_DATA for all trips in trips
+uint16_t payload_trip_data(const TripData *trips, uint8_t *buffer);
+
+// STATION_LIST for count stations. A code that is in all_stations is sent as
+// its index, any other code is sent with its name.
+uint16_t payload_station_list(const char *const *codes, const char *const *names, int count, uint8_t *buffer);
+
+// TRIP_DELTA for trip index, with the fields in mask taken from trips
+uint16_t payload_trip_delta(const TripData *trips, int index, uint8_t mask, uint8_t *buffer);
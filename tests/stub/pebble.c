@@ -0,0 +1,136 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <math.h>
+#include <pebble.h>
+
+// Host versions of the few SDK calls the tested modules make. The trig
+// lookups follow the SDK's fixed point scale: angles run from 0 to
+// TRIG_MAX_ANGLE clockwise from 12 o'clock, results from -TRIG_MAX_RATIO to
+// TRIG_MAX_RATIO.
+
+bool grect_equal(const GRect *rect_a, const GRect *rect_b) {
+  return rect_a->origin.x == rect_b->origin.x && rect_a->origin.y == rect_b->origin.y &&
+         rect_a->size.w == rect_b->size.w && rect_a->size.h == rect_b->size.h;
+}
+
+GPoint grect_center_point(const GRect *rect) {
+  return GPoint(rect->origin.x + rect->size.w / 2, rect->origin.y + rect->size.h / 2);
+}
+
+int32_t sin_lookup(int32_t angle) {
+  return (int32_t)lround(sin(2 * M_PI * angle / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+}
+
+int32_t cos_lookup(int32_t angle) {
+  return (int32_t)lround(cos(2 * M_PI * angle / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+}
+
+GPoint gpoint_from_polar(GRect rect, GOvalScaleMode scale_mode, int32_t angle) {
+  const GPoint center = grect_center_point(&rect);
+  const int radius = ((rect.size.w < rect.size.h) ? rect.size.w : rect.size.h) / 2;
+  return GPoint(center.x + sin_lookup(angle) * radius / TRIG_MAX_RATIO,
+                center.y - cos_lookup(angle) * radius / TRIG_MAX_RATIO);
+}
+
+#define STUB_PERSIST_SLOTS 32
+
+typedef struct {
+  bool used;
+  uint32_t key;
+  size_t length;
+  uint8_t data[PERSIST_DATA_MAX_LENGTH];
+} StubPersistSlot;
+
+struct StubResource {
+  const uint8_t *data;
+  size_t length;
+};
+
+static StubPersistSlot s_persist[STUB_PERSIST_SLOTS];
+static struct StubResource s_resource;
+
+static StubPersistSlot *prv_find_slot(uint32_t key) {
+  for (int i = 0; i < STUB_PERSIST_SLOTS; i++) {
+    if (s_persist[i].used && s_persist[i].key == key) { return &s_persist[i]; }
+  }
+  return NULL;
+}
+
+void stub_persist_clear(void) {
+  memset(s_persist, 0, sizeof(s_persist));
+}
+
+bool persist_exists(uint32_t key) {
+  return prv_find_slot(key) != NULL;
+}
+
+int persist_delete(uint32_t key) {
+  StubPersistSlot *slot = prv_find_slot(key);
+  if (slot) { slot->used = false; }
+  return 0;
+}
+
+int persist_write_data(uint32_t key, const void *data, size_t size) {
+  StubPersistSlot *slot = prv_find_slot(key);
+  for (int i = 0; !slot && i < STUB_PERSIST_SLOTS; i++) {
+    if (!s_persist[i].used) { slot = &s_persist[i]; }
+  }
+  if (!slot) { return -1; }
+  if (size > PERSIST_DATA_MAX_LENGTH) { size = PERSIST_DATA_MAX_LENGTH; }
+  slot->used = true;
+  slot->key = key;
+  slot->length = size;
+  memcpy(slot->data, data, size);
+  return size;
+}
+
+int persist_read_data(uint32_t key, void *buffer, size_t buffer_size) {
+  const StubPersistSlot *slot = prv_find_slot(key);
+  if (!slot) { return -1; }
+  const size_t length = (slot->length < buffer_size) ? slot->length : buffer_size;
+  memcpy(buffer, slot->data, length);
+  return length;
+}
+
+int persist_write_int(uint32_t key, int32_t value) {
+  return persist_write_data(key, &value, sizeof(value));
+}
+
+int32_t persist_read_int(uint32_t key) {
+  int32_t value = 0;
+  return (persist_read_data(key, &value, sizeof(value)) == sizeof(value)) ? value : 0;
+}
+
+void stub_resource_set(const uint8_t *data, size_t length) {
+  s_resource.data = data;
+  s_resource.length = length;
+}
+
+ResHandle resource_get_handle(uint32_t resource_id) {
+  return (resource_id == RESOURCE_ID_TIMETABLE) ? &s_resource : NULL;
+}
+
+size_t resource_size(ResHandle handle) {
+  return handle ? handle->length : 0;
+}
+
+size_t resource_load_byte_range(ResHandle handle, uint32_t start_offset, uint8_t *buffer, size_t num_bytes) {
+  if (!handle || start_offset >= handle->length) { return 0; }
+  if (num_bytes > handle->length - start_offset) { num_bytes = handle->length - start_offset; }
+  memcpy(buffer, handle->data + start_offset, num_bytes);
+  return num_bytes;
+}
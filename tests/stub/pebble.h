@@ -0,0 +1,129 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+// Stand-in for the SDK's pebble.h, so that the watch code that does not touch
+// the UI (protocol.c, trip_format.c, trip_leg.c, timetable.c, stations.c)
+// builds and runs on a host. Only the types and calls those files and the headers they
+// include need are declared; anything else is left out on purpose, so a
+// tested module that starts using the UI fails to build here.
+//
+// Builds define PBL_ROUND for the round geometry, PBL_RECT otherwise.
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef PBL_ROUND
+#define PBL_RECT 1
+#define PBL_IF_ROUND_ELSE(if_true, if_false) (if_false)
+#else
+#define PBL_IF_ROUND_ELSE(if_true, if_false) (if_true)
+#endif
+#define PBL_COLOR 1
+#define PBL_IF_COLOR_ELSE(if_true, if_false) (if_true)
+
+#define ARRAY_LENGTH(array) (sizeof(array) / sizeof((array)[0]))
+
+// Logging goes nowhere, tests feed the decoders bad payloads on purpose
+typedef enum {
+  APP_LOG_LEVEL_ERROR = 1,
+  APP_LOG_LEVEL_WARNING = 50,
+  APP_LOG_LEVEL_INFO = 100,
+  APP_LOG_LEVEL_DEBUG = 200,
+} AppLogLevel;
+#define APP_LOG(level, fmt, ...) ((void)(level))
+
+// Opaque UI types, only ever used through pointers by the tested code
+typedef struct Window Window;
+typedef struct Layer Layer;
+typedef struct TextLayer TextLayer;
+typedef struct MenuLayer MenuLayer;
+typedef struct AppTimer AppTimer;
+typedef struct Animation Animation;
+typedef struct GFont_ *GFont;
+typedef int32_t WakeupId;
+
+// Shared with the background worker through tracked_trip.h
+typedef struct {
+  uint16_t data0;
+  uint16_t data1;
+  uint16_t data2;
+} AppWorkerMessage;
+
+typedef enum {
+  SECOND_UNIT = 1 << 0,
+  MINUTE_UNIT = 1 << 1,
+  HOUR_UNIT = 1 << 2,
+} TimeUnits;
+
+// Geometry
+typedef struct {
+  int16_t x;
+  int16_t y;
+} GPoint;
+#define GPoint(x, y) ((GPoint){(x), (y)})
+
+typedef struct {
+  int16_t w;
+  int16_t h;
+} GSize;
+#define GSize(w, h) ((GSize){(w), (h)})
+
+typedef struct {
+  GPoint origin;
+  GSize size;
+} GRect;
+#define GRect(x, y, w, h) ((GRect){{(x), (y)}, {(w), (h)}})
+#define GRectZero GRect(0, 0, 0, 0)
+
+typedef enum {
+  GOvalScaleModeFitCircle,
+  GOvalScaleModeFillCircle,
+} GOvalScaleMode;
+
+#define TRIG_MAX_RATIO 0xffff
+#define TRIG_MAX_ANGLE 0x10000
+#define DEG_TO_TRIGANGLE(angle) (((angle) * TRIG_MAX_ANGLE) / 360)
+
+bool grect_equal(const GRect *rect_a, const GRect *rect_b);
+GPoint grect_center_point(const GRect *rect);
+int32_t sin_lookup(int32_t angle);
+int32_t cos_lookup(int32_t angle);
+GPoint gpoint_from_polar(GRect rect, GOvalScaleMode scale_mode, int32_t angle);
+
+// Persistent storage, kept in memory
+#define PERSIST_DATA_MAX_LENGTH 256
+bool persist_exists(uint32_t key);
+int persist_delete(uint32_t key);
+int32_t persist_read_int(uint32_t key);
+int persist_write_int(uint32_t key, int32_t value);
+int persist_read_data(uint32_t key, void *buffer, size_t buffer_size);
+int persist_write_data(uint32_t key, const void *data, size_t size);
+
+// Resources. The one resource the tested code reads is whatever the test
+// hands to stub_resource_set.
+#define RESOURCE_ID_TIMETABLE 1
+typedef const struct StubResource *ResHandle;
+ResHandle resource_get_handle(uint32_t resource_id);
+size_t resource_size(ResHandle handle);
+size_t resource_load_byte_range(ResHandle handle, uint32_t start_offset, uint8_t *buffer, size_t num_bytes);
+
+// Test hooks, not part of the SDK
+void stub_persist_clear(void);
+void stub_resource_set(const uint8_t *data, size_t length);
@@ -0,0 +1,192 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "unit.h"
+#include "payloads.h"
+#include "protocol.h"
+#include "stations.h"
+
+// Five trips with every field set, platforms of one to four characters
+static void prv_sample_trips(TripData *trips) {
+  static const char *platforms[] = { "8", "12a", "", "10ab", "3" };
+  memset(trips, 0, sizeof(*trips));
+  trips->count = MAX_TRIPS;
+  for (int i = 0; i < MAX_TRIPS; i++) {
+    trips->planned_departures[i] = 1760693400 + i * 1800;
+    trips->delays[i] = (i == 1) ? -1 : i * 3;
+    trips->departures[i] = trips->planned_departures[i] + trips->delays[i] * 60;
+    trips->planned_arrivals[i] = (i == 2) ? 0 : trips->planned_departures[i] + 3720;
+    trips->arrivals[i] = trips->planned_arrivals[i];
+    trips->transfers[i] = i;
+    trips->flags[i] = (i == 3) ? TRIP_FLAG_CANCELLED : 0;
+    strcpy(trips->platform[i], platforms[i]);
+  }
+}
+
+static void prv_check_trips_equal(const TripData *actual, const TripData *expected) {
+  CHECK_INT(actual->count, expected->count);
+  for (int i = 0; i < expected->count; i++) {
+    CHECK_INT(actual->departures[i], expected->departures[i]);
+    CHECK_INT(actual->planned_departures[i], expected->planned_departures[i]);
+    CHECK_INT(actual->planned_arrivals[i], expected->planned_arrivals[i]);
+    CHECK_INT(actual->arrivals[i], expected->arrivals[i]);
+    CHECK_INT(actual->delays[i], expected->delays[i]);
+    CHECK_INT(actual->transfers[i], expected->transfers[i]);
+    CHECK_INT(actual->flags[i], expected->flags[i]);
+    CHECK_STR(actual->platform[i], expected->platform[i]);
+  }
+}
+
+static void prv_test_trip_data(void) {
+  TripData expected, trips;
+  uint8_t payload[TRIP_RECORD_HEADER_SIZE + (MAX_TRIPS + 1) * TRIP_RECORD_SIZE];
+  prv_sample_trips(&expected);
+  uint16_t length = payload_trip_data(&expected, payload);
+
+  memset(&trips, 0xAA, sizeof(trips));
+  CHECK(protocol_decode_trip_data(payload, length, &trips));
+  prv_check_trips_equal(&trips, &expected);
+
+  // Fewer trips than fit
+  expected.count = 2;
+  length = payload_trip_data(&expected, payload);
+  CHECK(protocol_decode_trip_data(payload, length, &trips));
+  prv_check_trips_equal(&trips, &expected);
+
+  // More trips than fit are cut off at MAX_TRIPS
+  expected.count = MAX_TRIPS;
+  length = payload_trip_data(&expected, payload);
+  payload[1] = MAX_TRIPS + 1;
+  memcpy(payload + length, payload + TRIP_RECORD_HEADER_SIZE, TRIP_RECORD_SIZE);
+  CHECK(protocol_decode_trip_data(payload, length + TRIP_RECORD_SIZE, &trips));
+  prv_check_trips_equal(&trips, &expected);
+
+  // No trips at all is valid
+  expected.count = 0;
+  length = payload_trip_data(&expected, payload);
+  CHECK(protocol_decode_trip_data(payload, length, &trips));
+  CHECK_INT(trips.count, 0);
+
+  // Truncated, wrong version and empty payloads leave the trips alone
+  prv_sample_trips(&expected);
+  length = payload_trip_data(&expected, payload);
+  trips.count = 1;
+  CHECK(!protocol_decode_trip_data(payload, length - 1, &trips));
+  CHECK(!protocol_decode_trip_data(payload, 1, &trips));
+  payload[0] = TRIP_RECORD_VERSION + 1;
+  CHECK(!protocol_decode_trip_data(payload, length, &trips));
+  CHECK_INT(trips.count, 1);
+}
+
+static void prv_test_station_list(void) {
+  const char *codes[] = { "UT", "XYZ", "BD", "QQ" };
+  const char *names[] = { "", "Nowhere", "", "Elsewhere" };
+  uint8_t payload[MAX_CHUNKED_PAYLOAD_LENGTH];
+  StationData stations;
+  const int utrecht = station_index_for_code("UT");
+  CHECK(utrecht >= 0);
+
+  uint16_t length = payload_station_list(codes, names, 4, payload);
+  memset(&stations, 0, sizeof(stations));
+  CHECK(protocol_decode_station_list(payload, length, &stations));
+  CHECK_INT(stations.count, 4);
+  // Known stations point into all_stations, unknown ones into the pool
+  CHECK(stations.codes[0] == station_code(&all_stations[utrecht]));
+  CHECK(stations.names[0] == station_name(&all_stations[utrecht]));
+  CHECK_STR(stations.codes[1], "XYZ");
+  CHECK_STR(stations.names[1], "Nowhere");
+  CHECK(stations.names[1] >= stations.pool && stations.names[1] < stations.pool + MAX_STATION_POOL_LENGTH);
+  CHECK_STR(stations.codes[2], "BD");
+  CHECK_STR(stations.codes[3], "QQ");
+  CHECK_STR(stations.names[3], "Elsewhere");
+
+  // An index past the table is skipped
+  payload[2] = 0xFE;
+  payload[3] = 0xFF;
+  CHECK(protocol_decode_station_list(payload, length, &stations));
+  CHECK_INT(stations.count, 3);
+  CHECK_STR(stations.codes[0], "XYZ");
+
+  // A name cut off by the end of the payload ends the list
+  length = payload_station_list(codes, names, 2, payload);
+  CHECK(protocol_decode_station_list(payload, length - 1, &stations));
+  CHECK_INT(stations.count, 1);
+  CHECK_STR(stations.codes[0], "UT");
+
+  // Unknown stations that overflow the pool end the list
+  const char *long_codes[MAX_STATIONS];
+  const char *long_names[MAX_STATIONS];
+  for (int i = 0; i < MAX_STATIONS; i++) {
+    long_codes[i] = "ZZZZ";
+    long_names[i] = "A very long station name";
+  }
+  length = payload_station_list(long_codes, long_names, MAX_STATIONS, payload);
+  CHECK(protocol_decode_station_list(payload, length, &stations));
+  CHECK(stations.count > 0 && stations.count < MAX_STATIONS);
+
+  // Nothing decoded, wrong version or too short
+  length = payload_station_list(codes, names, 0, payload);
+  CHECK(!protocol_decode_station_list(payload, length, &stations));
+  length = payload_station_list(codes, names, 1, payload);
+  payload[0] = STATION_LIST_VERSION + 1;
+  CHECK(!protocol_decode_station_list(payload, length, &stations));
+  CHECK(!protocol_decode_station_list(payload, 1, &stations));
+}
+
+static void prv_test_trip_delta(void) {
+  TripData trips, update;
+  uint8_t payload[32];
+  int index = -1;
+  prv_sample_trips(&trips);
+  trips.loaded = true;
+  update = trips;
+  update.delays[2] = 7;
+  strcpy(update.platform[2], "5b");
+  update.departures[2] += 420;
+  update.flags[2] = TRIP_FLAG_CANCELLED;
+
+  // Only the masked fields change
+  uint16_t length = payload_trip_delta(&update, 2, TRIP_DELTA_DELAY | TRIP_DELTA_PLATFORM, payload);
+  CHECK_INT(protocol_apply_trip_delta(payload, length, &trips, &index), TRIP_DELTA_DELAY | TRIP_DELTA_PLATFORM);
+  CHECK_INT(index, 2);
+  CHECK_INT(trips.delays[2], 7);
+  CHECK_STR(trips.platform[2], "5b");
+  CHECK_INT(trips.departures[2], update.departures[2] - 420);
+  CHECK_INT(trips.flags[2], 0);
+
+  length = payload_trip_delta(&update, 2, TRIP_DELTA_DEPARTURE | TRIP_DELTA_FLAGS, payload);
+  CHECK_INT(protocol_apply_trip_delta(payload, length, &trips, &index), TRIP_DELTA_DEPARTURE | TRIP_DELTA_FLAGS);
+  prv_check_trips_equal(&trips, &update);
+
+  // Truncated, out of range, wrong version or before any trips were loaded
+  length = payload_trip_delta(&update, 2, TRIP_DELTA_DELAY | TRIP_DELTA_DEPARTURE, payload);
+  CHECK_INT(protocol_apply_trip_delta(payload, length - 1, &trips, &index), 0);
+  payload[1] = MAX_TRIPS;
+  CHECK_INT(protocol_apply_trip_delta(payload, length, &trips, &index), 0);
+  payload[1] = 2;
+  payload[0] = TRIP_DELTA_VERSION + 1;
+  CHECK_INT(protocol_apply_trip_delta(payload, length, &trips, &index), 0);
+  payload[0] = TRIP_DELTA_VERSION;
+  trips.loaded = false;
+  CHECK_INT(protocol_apply_trip_delta(payload, length, &trips, &index), 0);
+  prv_check_trips_equal(&trips, &update);
+}
+
+void test_protocol(void) {
+  prv_test_trip_data();
+  prv_test_station_list();
+  prv_test_trip_delta();
+}
@@ -0,0 +1,139 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdlib.h>
+#include "unit.h"
+#include "stations.h"
+#include "timetable.h"
+
+// The same routes packed by tools/generate_timetable.py (the built-in
+// resource) and by src/pkjs/timetable.js (the copy synced from the phone),
+// see tests/data/. The Makefile checks that both packers give the same bytes;
+// here both are decoded, from the resource and from persist.
+
+#define FRIDAY 1760659200  // 2025-10-17 00:00 UTC
+#define MINUTE 60
+#define HOUR (60 * MINUTE)
+#define DAY (24 * HOUR)
+
+typedef struct {
+  int departure;  // Seconds after FRIDAY
+  int duration;   // Minutes
+  int transfers;
+  const char *platform;
+} ExpectedTrip;
+
+static void prv_check_trips(const char *from, const char *to, int now, const ExpectedTrip *expected, int count) {
+  TripData trips;
+  memset(&trips, 0, sizeof(trips));
+  const bool found = timetable_fill_trips(station_index_for_code(from), station_index_for_code(to), FRIDAY + now, &trips);
+  CHECK_INT(found, count > 0);
+  if (!found) { return; }
+
+  CHECK_INT(trips.count, count);
+  for (int i = 0; i < count && i < trips.count; i++) {
+    CHECK_INT(trips.departures[i] - FRIDAY, expected[i].departure);
+    CHECK_INT(trips.planned_departures[i], trips.departures[i]);
+    CHECK_INT(trips.planned_arrivals[i] - trips.departures[i], expected[i].duration * MINUTE);
+    CHECK_INT(trips.transfers[i], expected[i].transfers);
+    CHECK_INT(trips.delays[i], 0);
+    CHECK_STR(trips.platform[i], expected[i].platform);
+  }
+}
+
+static void prv_check_lookups(void) {
+  // Late on a weekday: the last weekday train, then the weekend service
+  const ExpectedTrip friday_evening[] = {
+    { 22 * HOUR + 44 * MINUTE, 62, 1, "8" },
+    { DAY + 8 * HOUR + 14 * MINUTE, 62, 0, "" },
+    { DAY + 9 * HOUR + 14 * MINUTE, 62, 0, "" },
+  };
+  prv_check_trips("BD", "UT", 22 * HOUR + 20 * MINUTE, friday_evening, ARRAY_LENGTH(friday_evening));
+
+  // Early on a weekday: the first MAX_TRIPS of the day
+  ExpectedTrip friday_morning[MAX_TRIPS];
+  for (int i = 0; i < MAX_TRIPS; i++) {
+    friday_morning[i] = (ExpectedTrip){ 6 * HOUR + 14 * MINUTE + i * 30 * MINUTE, 62, 1, "8" };
+  }
+  prv_check_trips("BD", "UT", 5 * HOUR, friday_morning, MAX_TRIPS);
+
+  // Into the weekday service after a Sunday
+  ExpectedTrip sunday[MAX_TRIPS];
+  for (int i = 0; i < MAX_TRIPS; i++) {
+    sunday[i] = (ExpectedTrip){ 3 * DAY + 6 * HOUR + 14 * MINUTE + i * 30 * MINUTE, 62, 1, "8" };
+  }
+  prv_check_trips("BD", "UT", 2 * DAY + 10 * HOUR, sunday, MAX_TRIPS);
+
+  // Within one hour and over midnight, on a platform of three characters
+  const ExpectedTrip late[] = {
+    { 23 * HOUR + 20 * MINUTE, 60, 0, "12a" },
+    { 23 * HOUR + 35 * MINUTE, 60, 0, "12a" },
+    { DAY + 23 * HOUR + 5 * MINUTE, 60, 0, "12a" },
+    { DAY + 23 * HOUR + 20 * MINUTE, 60, 0, "12a" },
+    { DAY + 23 * HOUR + 35 * MINUTE, 60, 0, "12a" },
+  };
+  prv_check_trips("UT", "BD", 23 * HOUR + 10 * MINUTE, late, ARRAY_LENGTH(late));
+
+  // Routes that are not in the timetable
+  prv_check_trips("BD", "ASD", 12 * HOUR, NULL, 0);
+  prv_check_trips("UT", "UT", 12 * HOUR, NULL, 0);
+}
+
+static void prv_test_timetable(const char *path) {
+  static uint8_t data[TIMETABLE_MAX_SYNCED_LENGTH + 1];
+  FILE *file = fopen(path, "rb");
+  CHECK(file != NULL);
+  if (!file) { return; }
+  const size_t length = fread(data, 1, sizeof(data), file);
+  fclose(file);
+  CHECK(length > TIMETABLE_PAGE_SIZE && length <= TIMETABLE_MAX_SYNCED_LENGTH);
+
+  // Built into the app
+  stub_persist_clear();
+  stub_resource_set(data, length);
+  prv_check_lookups();
+
+  // Synced from the phone, split over persist pages
+  stub_resource_set(NULL, 0);
+  CHECK(timetable_store(data, length));
+  CHECK_INT(persist_read_int(PERSIST_KEY_TIMETABLE_LENGTH), length);
+  CHECK(persist_exists(PERSIST_KEY_TIMETABLE_BASE + 1));
+  CHECK(!persist_exists(PERSIST_KEY_TIMETABLE_BASE + 2));
+  prv_check_lookups();
+
+  // Invalid timetables leave the stored one alone
+  data[2] = TIMETABLE_VERSION + 1;
+  CHECK(!timetable_store(data, length));
+  data[2] = TIMETABLE_VERSION;
+  CHECK(!timetable_store(data, TIMETABLE_MAX_SYNCED_LENGTH + 1));
+  CHECK(!timetable_store(data, TIMETABLE_HEADER_SIZE - 1));
+  CHECK_INT(persist_read_int(PERSIST_KEY_TIMETABLE_LENGTH), length);
+
+  // A timetable without routes removes it
+  const uint8_t empty[] = { 'T', 'T', TIMETABLE_VERSION, 0 };
+  CHECK(timetable_store(empty, sizeof(empty)));
+  CHECK(!persist_exists(PERSIST_KEY_TIMETABLE_LENGTH));
+  CHECK(!persist_exists(PERSIST_KEY_TIMETABLE_BASE));
+  CHECK(!persist_exists(PERSIST_KEY_TIMETABLE_BASE + 1));
+  prv_check_trips("BD", "UT", 5 * HOUR, NULL, 0);
+}
+
+void test_timetable(const char *const *paths, int count) {
+  CHECK(count > 0);
+  for (int i = 0; i < count; i++) {
+    prv_test_timetable(paths[i]);
+  }
+}
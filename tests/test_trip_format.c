@@ -0,0 +1,107 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "unit.h"
+#include "trip_format.h"
+
+static void prv_test_first_upcoming(void) {
+  TripData trips;
+  memset(&trips, 0, sizeof(trips));
+  CHECK_INT(trip_format_first_upcoming(&trips, 0), -1);
+
+  trips.count = 3;
+  trips.departures[0] = 1000;
+  trips.departures[1] = 2000;
+  trips.departures[2] = 3000;
+  CHECK_INT(trip_format_first_upcoming(&trips, 999), 0);
+  CHECK_INT(trip_format_first_upcoming(&trips, 1000), 1);
+  CHECK_INT(trip_format_first_upcoming(&trips, 2500), 2);
+  CHECK_INT(trip_format_first_upcoming(&trips, 3000), -1);
+}
+
+static void prv_test_countdown(void) {
+  char buffer[16];
+  const time_t now = 1760693400;
+
+  CHECK_INT(trip_format_countdown(0, 0, now, buffer, sizeof(buffer)), -1);
+  CHECK_STR(buffer, "--:--");
+  CHECK_INT(trip_format_countdown(now + 600, TRIP_FLAG_CANCELLED, now, buffer, sizeof(buffer)), -1);
+  CHECK_STR(buffer, "--:--");
+
+  // HH:MM from an hour out, MM:SS below that
+  CHECK_INT(trip_format_countdown(now + 3725, 0, now, buffer, sizeof(buffer)), 3725);
+  CHECK_STR(buffer, "01:02");
+  CHECK_INT(trip_format_countdown(now + 3600, 0, now, buffer, sizeof(buffer)), 3600);
+  CHECK_STR(buffer, "01:00");
+  CHECK_INT(trip_format_countdown(now + 3599, 0, now, buffer, sizeof(buffer)), 3599);
+  CHECK_STR(buffer, "59:59");
+  CHECK_INT(trip_format_countdown(now + 1, 0, now, buffer, sizeof(buffer)), 1);
+  CHECK_STR(buffer, "00:01");
+
+  CHECK_INT(trip_format_countdown(now, 0, now, buffer, sizeof(buffer)), 0);
+  CHECK_STR(buffer, "Departed");
+  CHECK_INT(trip_format_countdown(now - 60, 0, now, buffer, sizeof(buffer)), 0);
+  CHECK_STR(buffer, "Departed");
+
+  // Cut off at the buffer size rather than overflowing it
+  char small[4];
+  trip_format_countdown(now + 125, 0, now, small, sizeof(small));
+  CHECK_STR(small, "02:");
+}
+
+static void prv_test_clock_time(void) {
+  char buffer[8];
+  trip_format_clock_time(0, buffer, sizeof(buffer));
+  CHECK_STR(buffer, "--:--");
+  trip_format_clock_time(1760693400, buffer, sizeof(buffer));  // 2025-10-17 09:30 UTC
+  CHECK_STR(buffer, "09:30");
+  trip_format_clock_time(1760745599, buffer, sizeof(buffer));
+  CHECK_STR(buffer, "23:59");
+}
+
+static void prv_test_delay(void) {
+  TripData trips;
+  char buffer[16];
+  memset(&trips, 0, sizeof(trips));
+  trips.count = 1;
+
+  trip_format_delay(&trips, 0, buffer, sizeof(buffer));
+  CHECK_STR(buffer, "On time");
+  trips.delays[0] = -2;
+  trip_format_delay(&trips, 0, buffer, sizeof(buffer));
+  CHECK_STR(buffer, "On time");
+  trips.delays[0] = 12;
+  trip_format_delay(&trips, 0, buffer, sizeof(buffer));
+  CHECK_STR(buffer, "+12");
+
+  // Cached and scheduled trips don't claim a live delay, cancelled ones show none
+  trips.stale = true;
+  trip_format_delay(&trips, 0, buffer, sizeof(buffer));
+  CHECK_STR(buffer, "Cached");
+  trips.scheduled = true;
+  trip_format_delay(&trips, 0, buffer, sizeof(buffer));
+  CHECK_STR(buffer, "Scheduled");
+  trips.flags[0] = TRIP_FLAG_CANCELLED;
+  trip_format_delay(&trips, 0, buffer, sizeof(buffer));
+  CHECK_STR(buffer, "");
+}
+
+void test_trip_format(void) {
+  prv_test_first_upcoming();
+  prv_test_countdown();
+  prv_test_clock_time();
+  prv_test_delay();
+}
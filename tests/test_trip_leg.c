@@ -0,0 +1,149 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdlib.h>
+#include "unit.h"
+#include "trip_leg.h"
+
+static bool prv_geometry_equal(const TripLegGeometry *a, const TripLegGeometry *b) {
+  if (a->leg_count != b->leg_count) { return false; }
+  for (int i = 0; i < a->leg_count * 2; i++) {
+    if (a->dots[i].x != b->dots[i].x || a->dots[i].y != b->dots[i].y) { return false; }
+  }
+  return true;
+}
+
+#ifdef PBL_ROUND
+static void prv_test_layout(void) {
+  const GRect bounds = GRect(0, 0, 180, 180);
+  const GPoint center = grect_center_point(&bounds);
+  TripLegGeometry geometry;
+
+  trip_leg_layout(bounds, 0, &geometry);
+  CHECK_INT(geometry.leg_count, 1);
+  CHECK_INT(geometry.polar_rect.origin.x, 8);
+  CHECK_INT(geometry.polar_rect.size.w, 164);
+  // One leg centred on 3 o'clock: dots mirrored around the horizontal axis,
+  // give or take the rounding of the fixed point angles
+  CHECK(geometry.angles[0] < TRIG_MAX_ANGLE / 4 && geometry.angles[1] > TRIG_MAX_ANGLE / 4);
+  CHECK(abs(geometry.angles[0] + geometry.angles[1] - TRIG_MAX_ANGLE / 2) <= 1);
+  CHECK_INT(geometry.dots[0].x, geometry.dots[1].x);
+  CHECK(abs(geometry.dots[0].y + geometry.dots[1].y - center.y * 2) <= 1);
+
+  // Legs run clockwise, within the 80 degree arc, on the circle
+  trip_leg_layout(bounds, 3, &geometry);
+  CHECK_INT(geometry.leg_count, 4);
+  for (int i = 0; i < geometry.leg_count * 2; i++) {
+    if (i > 0) { CHECK(geometry.angles[i] > geometry.angles[i - 1]); }
+    CHECK(geometry.angles[i] >= DEG_TO_TRIGANGLE(50) && geometry.angles[i] <= DEG_TO_TRIGANGLE(130));
+    const int dx = geometry.dots[i].x - center.x;
+    const int dy = geometry.dots[i].y - center.y;
+    CHECK(dx * dx + dy * dy >= 81 * 81 && dx * dx + dy * dy <= 83 * 83);
+  }
+}
+#else
+static void prv_test_layout(void) {
+  const GRect bounds = GRect(0, 0, 144, 168);
+  TripLegGeometry geometry;
+
+  trip_leg_layout(bounds, 0, &geometry);
+  CHECK_INT(geometry.leg_count, 1);
+  CHECK_INT(geometry.dots[0].x, 132);
+  CHECK_INT(geometry.dots[0].y, 51);
+  CHECK_INT(geometry.dots[1].x, 132);
+  CHECK_INT(geometry.dots[1].y, 117);
+
+  trip_leg_layout(bounds, 1, &geometry);
+  CHECK_INT(geometry.leg_count, 2);
+  CHECK_INT(geometry.dots[0].y, 45);
+  CHECK_INT(geometry.dots[1].y, 79);
+  CHECK_INT(geometry.dots[2].y, 89);
+  CHECK_INT(geometry.dots[3].y, 123);
+
+  // Legs run down the right edge, between 40 pixels from the top and bottom
+  trip_leg_layout(bounds, 5, &geometry);
+  CHECK_INT(geometry.leg_count, 6);
+  for (int i = 0; i < geometry.leg_count * 2; i++) {
+    CHECK_INT(geometry.dots[i].x, bounds.size.w - 12);
+    if (i > 0) { CHECK(geometry.dots[i].y > geometry.dots[i - 1].y); }
+    CHECK(geometry.dots[i].y >= 40 && geometry.dots[i].y <= bounds.size.h - 40);
+  }
+}
+#endif
+
+static void prv_test_leg_limit(void) {
+  TripLegGeometry geometry;
+  trip_leg_layout(GRect(0, 0, 180, 180), MAX_TRIP_LEGS + 5, &geometry);
+  CHECK_INT(geometry.leg_count, MAX_TRIP_LEGS);
+}
+
+#ifdef PBL_ROUND
+static void prv_test_geometry(void) {
+  const GRect bounds = GRect(0, 0, 180, 180);
+  TripLegGeometry expected;
+  TripLegGeometry scratch;
+  trip_leg_cache_clear();
+
+  const TripLegGeometry *direct = trip_leg_geometry(bounds, 0, &scratch);
+  const TripLegGeometry *one = trip_leg_geometry(bounds, 1, &scratch);
+  const TripLegGeometry *two = trip_leg_geometry(bounds, 2, &scratch);
+  CHECK(direct != &scratch);
+  CHECK(trip_leg_geometry(bounds, 0, &scratch) == direct);
+  trip_leg_layout(bounds, 1, &expected);
+  CHECK(prv_geometry_equal(one, &expected));
+
+  // A fourth leg count takes the least recently used entry, here the one for
+  // a single transfer, and a transfer count past the limit shares the entry
+  // of the limit
+  const TripLegGeometry *three = trip_leg_geometry(bounds, 3, &scratch);
+  CHECK(three == one);
+  CHECK(trip_leg_geometry(bounds, 0, &scratch) == direct);
+  CHECK(trip_leg_geometry(bounds, 2, &scratch) == two);
+  trip_leg_layout(bounds, 3, &expected);
+  CHECK(prv_geometry_equal(three, &expected));
+  CHECK(trip_leg_geometry(bounds, MAX_TRIP_LEGS + 5, &scratch) == trip_leg_geometry(bounds, MAX_TRIP_LEGS - 1, &scratch));
+
+  // Other bounds lay everything out again
+  const GRect obstructed = GRect(0, 0, 180, 129);
+  trip_leg_layout(obstructed, 0, &expected);
+  CHECK(prv_geometry_equal(trip_leg_geometry(obstructed, 0, &scratch), &expected));
+  trip_leg_layout(obstructed, 2, &expected);
+  CHECK(prv_geometry_equal(trip_leg_geometry(obstructed, 2, &scratch), &expected));
+}
+#else
+// Without a cache every call lays out into scratch
+static void prv_test_geometry(void) {
+  const GRect bounds = GRect(0, 0, 144, 168);
+  TripLegGeometry expected;
+  TripLegGeometry scratch;
+
+  trip_leg_layout(bounds, 1, &expected);
+  CHECK(trip_leg_geometry(bounds, 1, &scratch) == &scratch);
+  CHECK(prv_geometry_equal(&scratch, &expected));
+  trip_leg_layout(bounds, MAX_TRIP_LEGS + 5, &expected);
+  CHECK(prv_geometry_equal(trip_leg_geometry(bounds, MAX_TRIP_LEGS + 5, &scratch), &expected));
+
+  const GRect obstructed = GRect(0, 0, 144, 117);
+  trip_leg_layout(obstructed, 2, &expected);
+  CHECK(prv_geometry_equal(trip_leg_geometry(obstructed, 2, &scratch), &expected));
+}
+#endif
+
+void test_trip_leg(void) {
+  prv_test_layout();
+  prv_test_leg_limit();
+  prv_test_geometry();
+}
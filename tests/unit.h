@@ -0,0 +1,58 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stdio.h>
+#include <string.h>
+
+// Minimal test harness for the host build. A failed check prints where it
+// failed and lets the test go on, so one run reports every broken check.
+
+extern int unit_checks;
+extern int unit_failures;
+
+void unit_fail(const char *file, int line, const char *message);
+
+#define CHECK(condition) do { \
+    unit_checks++; \
+    if (!(condition)) { unit_fail(__FILE__, __LINE__, #condition); } \
+  } while (0)
+
+#define CHECK_INT(actual, expected) do { \
+    long actual_value = (long)(actual), expected_value = (long)(expected); \
+    char message[160]; \
+    unit_checks++; \
+    if (actual_value != expected_value) { \
+      snprintf(message, sizeof(message), "%s is %ld, expected %ld", #actual, actual_value, expected_value); \
+      unit_fail(__FILE__, __LINE__, message); \
+    } \
+  } while (0)
+
+#define CHECK_STR(actual, expected) do { \
+    const char *actual_value = (actual), *expected_value = (expected); \
+    char message[160]; \
+    unit_checks++; \
+    if (strcmp(actual_value, expected_value) != 0) { \
+      snprintf(message, sizeof(message), "%s is \"%s\", expected \"%s\"", #actual, actual_value, expected_value); \
+      unit_fail(__FILE__, __LINE__, message); \
+    } \
+  } while (0)
+
+// One per test file
+void test_protocol(void);
+void test_trip_format(void);
+void test_trip_leg(void);
+void test_timetable(const char *const *paths, int count);  // Packed timetables to decode
@@ -0,0 +1,42 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdlib.h>
+#include <time.h>
+#include "unit.h"
+
+int unit_checks;
+int unit_failures;
+
+void unit_fail(const char *file, int line, const char *message) {
+  unit_failures++;
+  fprintf(stderr, "%s:%d: %s\n", file, line, message);
+}
+
+// Arguments: packed timetables for test_timetable
+int main(int argc, char **argv) {
+  // Clock times are formatted in local time
+  setenv("TZ", "UTC", 1);
+  tzset();
+
+  test_protocol();
+  test_trip_format();
+  test_trip_leg();
+  test_timetable((const char *const *)argv + 1, argc - 1);
+
+  printf("%d checks, %d failed\n", unit_checks, unit_failures);
+  return unit_failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
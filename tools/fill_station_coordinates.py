@@ -0,0 +1,78 @@
+#
+# This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+# Copyright (c) 2025 Guus Beckett.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, version 3.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+"""
+Adds coordinates from the NS stations API to src/pkjs/stations.json, so the
+phone can find nearby stations without an API call (src/pkjs/station_grid.js).
+Stations the API does not know keep their entry without coordinates. The file
+keeps its one-station-per-line layout.
+
+Usage: fill_station_coordinates.py --key KEY [stations.json]
+"""
+import argparse
+import io
+import json
+import sys
+import urllib.request
+
+STATIONS_URL = "https://gateway.apiportal.ns.nl/reisinformatie-api/api/v2/stations"
+COORDINATE_DECIMALS = 5  # About a metre
+KEY_ORDER = ("code", "name", "top", "lat", "lng")
+
+
+def fetch_coordinates(key):
+    request = urllib.request.Request(STATIONS_URL, headers={"Ocp-Apim-Subscription-Key": key})
+    with urllib.request.urlopen(request) as response:
+        payload = json.load(response)["payload"]
+    return {station["code"].upper(): (station["lat"], station["lng"])
+            for station in payload if "lat" in station and "lng" in station}
+
+
+def format_station(station):
+    ordered = [(key, station[key]) for key in KEY_ORDER if key in station]
+    ordered += [(key, value) for key, value in station.items() if key not in KEY_ORDER]
+    return "  " + json.dumps(dict(ordered), ensure_ascii=False)
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description="Fill in station coordinates from the NS API.")
+    parser.add_argument("--key", required=True, help="NS API subscription key")
+    parser.add_argument("stations", nargs="?", default="src/pkjs/stations.json")
+    options = parser.parse_args(argv[1:])
+
+    with io.open(options.stations, encoding="utf-8") as f:
+        stations = json.load(f)
+    coordinates = fetch_coordinates(options.key)
+
+    missing = []
+    for station in stations:
+        if station["code"] in coordinates:
+            lat, lng = coordinates[station["code"]]
+            station["lat"] = round(lat, COORDINATE_DECIMALS)
+            station["lng"] = round(lng, COORDINATE_DECIMALS)
+        else:
+            missing.append(station["code"])
+
+    with io.open(options.stations, "w", encoding="utf-8") as f:
+        f.write("[\n" + ",\n".join(format_station(station) for station in stations) + "\n]\n")
+
+    print("Coordinates for {} of {} stations".format(len(stations) - len(missing), len(stations)))
+    if missing:
+        print("Not found: " + ", ".join(missing))
+
+
+if __name__ == '__main__':
+    main(sys.argv)
@@ -0,0 +1,268 @@
+#
+# This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+# Copyright (c) 2025 Guus Beckett.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, version 3.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+"""
+Generates the watch's station table (stations.auto.h) from the canonical
+station list in src/pkjs/stations.json, which the phone bundles as well.
+
+Stations are sorted the Dutch way: a leading article ("De", "'t") is ignored,
+so "De Vink" is listed under V. The alphabet index is derived from that order.
+A minimal perfect hash maps every station code to its index in that order.
+Any inconsistency in the source data raises StationDataError, which fails the
+build.
+
+The header always defines the table sizes. The tables themselves are only
+defined where STATION_TABLE_DEFINITIONS is set (src/c/stations.c), everything
+else sees the extern declarations in src/c/stations.h.
+
+Usage: generate_stations.py <stations.json> <stations.auto.h>
+"""
+import io
+import json
+import re
+import sys
+
+MAX_CODE_LENGTH = 4    # MAX_STATION_CODE_LENGTH - 1 in trein_data.h
+MAX_NAME_BYTES = 31    # MAX_STATION_NAME_LENGTH - 1 in trein_data.h
+ARTICLES = ("De ", "'t ")
+CODE_PATTERN = re.compile(r'^[A-Z]+$')
+HASH_BUCKET_SIZE = 4   # Average number of codes per bucket of the perfect hash
+MAX_HASH_SEED = 0xFFFF
+LAT_RANGE = (49.0, 55.0)  # Coordinates are only used by the phone, but must be
+LNG_RANGE = (2.0, 10.0)   # plausible for the Netherlands and its border stations
+
+
+class StationDataError(Exception):
+    pass
+
+
+def article_length(name):
+    for article in ARTICLES:
+        if name.startswith(article):
+            return len(article)
+    return 0
+
+
+def sort_key(station):
+    """Sort key shared with src/pkjs/station_table.js, keep the two in sync."""
+    name = station['name'][article_length(station['name']):]
+    return (name.lower(), station['name'].lower(), station['code'])
+
+
+def is_coordinate(value, value_range):
+    return isinstance(value, (int, float)) and value_range[0] <= value <= value_range[1]
+
+
+def load_stations(path):
+    with io.open(path, encoding='utf-8') as f:
+        stations = json.load(f)
+
+    seen_codes = set()
+    top_ranks = {}
+    for station in stations:
+        code = station.get('code', '')
+        name = station.get('name', '')
+        if not CODE_PATTERN.match(code) or len(code) > MAX_CODE_LENGTH:
+            raise StationDataError('Invalid station code: %r' % code)
+        if code in seen_codes:
+            raise StationDataError('Duplicate station code: %s' % code)
+        seen_codes.add(code)
+        if not name or len(name.encode('utf-8')) > MAX_NAME_BYTES:
+            raise StationDataError('Invalid name for %s: %r' % (code, name))
+        if ('lat' in station) != ('lng' in station):
+            raise StationDataError('%s needs both lat and lng, or neither' % code)
+        if 'lat' in station and not (is_coordinate(station['lat'], LAT_RANGE) and
+                                     is_coordinate(station['lng'], LNG_RANGE)):
+            raise StationDataError('Invalid coordinates for %s: %r, %r' % (code, station['lat'], station['lng']))
+        if 'top' in station:
+            rank = station['top']
+            if rank in top_ranks:
+                raise StationDataError('Top rank %d used by %s and %s' % (rank, top_ranks[rank], code))
+            top_ranks[rank] = code
+
+    if sorted(top_ranks) != list(range(1, len(top_ranks) + 1)):
+        raise StationDataError('Top ranks must run from 1 to %d without gaps' % len(top_ranks))
+
+    stations = sorted(stations, key=sort_key)
+    for station in stations:
+        letter = sort_key(station)[0][0].upper()
+        if not 'A' <= letter <= 'Z':
+            raise StationDataError('%s does not sort under a letter A-Z' % station['code'])
+        station['letter'] = letter
+    return stations
+
+
+def pack_code(code):
+    """Codes as the watch hashes them: up to four characters, little-endian."""
+    key = 0
+    for i, byte in enumerate(bytearray(code.encode('ascii'))):
+        key |= byte << (8 * i)
+    return key
+
+
+def hash_code(key, seed):
+    """32-bit mix of a packed code, identical to prv_hash() in src/c/stations.c."""
+    x = (key ^ (seed * 0x9E3779B9)) & 0xFFFFFFFF
+    x ^= x >> 16
+    x = (x * 0x85EBCA6B) & 0xFFFFFFFF
+    x ^= x >> 13
+    x = (x * 0xC2B2AE35) & 0xFFFFFFFF
+    x ^= x >> 16
+    return x
+
+
+def build_perfect_hash(stations):
+    """Hash and displace: codes are grouped into buckets by hash_code(key, 0),
+    then each bucket, largest first, gets the first seed that places all of
+    its codes in free slots via hash_code(key, seed). Returns the seed per
+    bucket and the station index per slot."""
+    count = len(stations)
+    bucket_count = count // HASH_BUCKET_SIZE + 1
+    buckets = [[] for _ in range(bucket_count)]
+    for index, station in enumerate(stations):
+        key = pack_code(station['code'])
+        buckets[hash_code(key, 0) % bucket_count].append((key, index))
+
+    seeds = [0] * bucket_count
+    slots = [None] * count
+    for bucket in sorted(range(bucket_count), key=lambda b: -len(buckets[b])):
+        entries = buckets[bucket]
+        if not entries:
+            break
+        for seed in range(1, MAX_HASH_SEED + 1):
+            placed = [hash_code(key, seed) % count for key, _ in entries]
+            if len(set(placed)) == len(placed) and all(slots[slot] is None for slot in placed):
+                break
+        else:
+            raise StationDataError('No perfect hash seed found for bucket %d' % bucket)
+        seeds[bucket] = seed
+        for slot, (_, index) in zip(placed, entries):
+            slots[slot] = index
+    return seeds, slots
+
+
+def c_string(value):
+    """Quote a string as C literals, escaping non-ASCII bytes. A literal is
+    closed after each escape so the next character can't extend it."""
+    parts = []
+    current = ''
+    for byte in bytearray(value.encode('utf-8')):
+        if byte < 0x20 or byte >= 0x7f or byte in (ord('"'), ord('\\')):
+            parts.append(current + '\\x%02x' % byte)
+            current = ''
+        else:
+            current += chr(byte)
+    parts.append(current)
+    return ' '.join('"%s"' % part for part in parts if part) or '""'
+
+
+def c_array(type_name, name, values, per_line=16):
+    lines = ['const %s %s[] = {' % (type_name, name)]
+    for i in range(0, len(values), per_line):
+        lines.append('    %s,' % ', '.join(values[i:i + per_line]))
+    return lines + ['};']
+
+
+def render_header(stations):
+    defines = []
+    tables = []
+
+    # Codes and names of all stations, each NUL terminated
+    strings = ['// Codes and names of all stations, each NUL terminated',
+               'const char station_strings[] =']
+    offsets = []
+    offset = 0
+    for station in stations:
+        code_offset = offset
+        offset += len(station['code'].encode('utf-8')) + 1
+        name_offset = offset
+        offset += len(station['name'].encode('utf-8')) + 1
+        offsets.append((code_offset, name_offset))
+        strings.append('    %s "\\0" %s "\\0"' % (c_string(station['code']), c_string(station['name'])))
+    if offset > 0xFFFF:
+        raise StationDataError('Station strings exceed 16-bit offsets (%d bytes)' % offset)
+    strings[-1] += ';'
+    tables += strings + ['']
+
+    tables += ['// Sorted alphabetically, ignoring a leading "De" or "\'t"']
+    tables += c_array('Station', 'all_stations', ['{%d, %d}' % pair for pair in offsets], 8) + ['']
+    defines += ['#define NUM_STATIONS %d' % len(stations)]
+
+    top = sorted((s['top'], i) for i, s in enumerate(stations) if 'top' in s)
+    tables += ['// The busiest stations in the Netherlands, as indices into all_stations']
+    tables += c_array('uint16_t', 'top_stations', [str(i) for _, i in top]) + ['']
+    defines += ['#define NUM_TOP_STATIONS %d' % len(top)]
+
+    letters = []
+    for i, station in enumerate(stations):
+        if letters and letters[-1][0] == station['letter']:
+            letters[-1][2] += 1
+        else:
+            letters.append([station['letter'], i, 1])
+    if any(count > 0xFF for _, _, count in letters):
+        raise StationDataError('More than 255 stations under one letter')
+
+    # all_stations is sorted on names without their article, which is what a
+    # prefix search needs. Stations with an article get a second index, sorted
+    # on their full name, so typing "De V" finds "De Vink" too.
+    with_article = [i for i, s in enumerate(stations) if article_length(s['name'])]
+    with_article.sort(key=lambda i: (stations[i]['name'].lower(), stations[i]['code']))
+    if len(with_article) > 0xFF:
+        raise StationDataError('More than 255 stations with an article')
+    tables += ['// Articles ignored when sorting, see sort_key() in tools/generate_stations.py',
+               'const char *const station_articles[] = {%s};' % ', '.join(c_string(a) for a in ARTICLES),
+               '',
+               '// Stations whose name starts with an article, sorted on the full name']
+    tables += c_array('uint16_t', 'station_article_index', [str(i) for i in with_article]) + ['']
+    defines += ['#define NUM_STATION_ARTICLES %d' % len(ARTICLES),
+                '#define NUM_STATION_ARTICLE_INDEX %d' % len(with_article)]
+
+    tables += ['// Where each letter\'s stations start in all_stations and how many there are']
+    tables += c_array('AlphabetIndex', 'alphabet_index', ["{'%s', %d, %d}" % tuple(entry) for entry in letters], 4) + ['']
+    defines += ['#define ALPHABET_INDEX_COUNT %d' % len(letters)]
+
+    seeds, slots = build_perfect_hash(stations)
+    seed_type = 'uint8_t' if max(seeds) <= 0xFF else 'uint16_t'
+    tables += ['// Minimal perfect hash from station code to all_stations index, see',
+               '// station_index_for_code() in src/c/stations.c']
+    tables += c_array('%s' % seed_type, 'station_hash_seeds', [str(seed) for seed in seeds]) + ['']
+    tables += c_array('uint16_t', 'station_hash_slots', [str(index) for index in slots]) + ['']
+    defines += ['#define STATION_HASH_BUCKETS %d' % len(seeds),
+                '#define STATION_HASH_SEED_TYPE %s' % seed_type]
+
+    lines = ['// Generated by tools/generate_stations.py from src/pkjs/stations.json. Do not edit.',
+             '#pragma once',
+             '']
+    lines += defines
+    lines += ['', '#ifdef STATION_TABLE_DEFINITIONS', '']
+    lines += tables
+    lines += ['#endif', '']
+    return '\n'.join(lines)
+
+
+def generate(json_path, header_path):
+    stations = load_stations(json_path)
+    with io.open(header_path, 'w', encoding='utf-8') as f:
+        f.write(render_header(stations))
+
+
+if __name__ == '__main__':
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    try:
+        generate(sys.argv[1], sys.argv[2])
+    except StationDataError as e:
+        sys.exit('Station data error: %s' % e)
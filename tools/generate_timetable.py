@@ -0,0 +1,188 @@
+#
+# This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+# Copyright (c) 2025 Guus Beckett.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, version 3.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+"""
+Packs the offline timetable (resources/data/timetable.json) into the binary
+resource the watch reads (resources/data/timetable.bin, RESOURCE_ID_TIMETABLE).
+The layout is described under "Timetable Resource" in src/c/trein_data.h.
+
+Each route lists services; a service runs on some days, either at explicit
+times or every N minutes from a first to a last departure:
+
+  {"routes": [{"from": "BD", "to": "UT", "services": [
+    {"days": "Mon-Fri", "first": "06:14", "last": "22:44", "every": 30,
+     "duration": 62, "transfers": 1, "platform": "8"},
+    {"days": "Sat,Sun", "times": ["08:14", "09:14"], "duration": 62}]}]}
+
+Station codes are stored as indices into the watch's station table, so the
+file has to be regenerated when stations.json changes. Routes entered on the
+phone's settings page are packed the same way by src/pkjs/timetable.js;
+`make -C tests` checks that both give the same bytes. The build fails when
+timetable.bin is out of date (see wscript).
+
+Usage: generate_timetable.py [timetable.json] [stations.json] [timetable.bin]
+"""
+import io
+import json
+import struct
+import sys
+
+import generate_stations
+
+VERSION = 3                  # TIMETABLE_VERSION in trein_data.h
+PLATFORM_SIZE = 4            # TIMETABLE_PLATFORM_SIZE
+HOUR_INDEX_COUNT = 25        # TIMETABLE_HOUR_INDEX_COUNT
+NO_PLATFORM = 0x0F           # TIMETABLE_NO_PLATFORM
+MAX_PLATFORMS = NO_PLATFORM  # Per route, the index shares a byte with transfers
+MAX_SERVICES = 16            # TIMETABLE_MAX_SERVICES
+MAX_TRANSFERS = 15
+MAX_DURATION = 255
+DAYS = ("Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat")  # Bit 0 is Sunday, like tm_wday
+
+DEFAULT_PATHS = ("resources/data/timetable.json", "src/pkjs/stations.json", "resources/data/timetable.bin")
+
+
+class TimetableError(Exception):
+    pass
+
+
+def parse_days(spec):
+    """'Mon-Fri', 'Sat,Sun' or 'Mon-Sun' to a day mask."""
+    mask = 0
+    for part in spec.split(","):
+        ends = [day.strip() for day in part.split("-")]
+        if any(day not in DAYS for day in ends) or len(ends) > 2:
+            raise TimetableError("Invalid days: %r" % spec)
+        first, last = DAYS.index(ends[0]), DAYS.index(ends[-1])
+        day = first
+        while True:
+            mask |= 1 << day
+            if day == last:
+                break
+            day = (day + 1) % 7
+    return mask
+
+
+def parse_time(value):
+    try:
+        hours, minutes = (int(part) for part in value.split(":"))
+    except ValueError:
+        raise TimetableError("Invalid time: %r" % value)
+    if not (0 <= hours < 24 and 0 <= minutes < 60):
+        raise TimetableError("Invalid time: %r" % value)
+    return hours * 60 + minutes
+
+
+def service_departures(service):
+    if "times" in service:
+        return [parse_time(value) for value in service["times"]]
+    first, last, every = parse_time(service["first"]), parse_time(service["last"]), service["every"]
+    if every <= 0 or last < first:
+        raise TimetableError("Invalid service from %s to %s every %r" % (service["first"], service["last"], every))
+    return list(range(first, last + 1, every))
+
+
+def pack_route(route, station_index):
+    for key in ("from", "to"):
+        if route.get(key) not in station_index:
+            raise TimetableError("Unknown station: %r" % route.get(key))
+
+    # Platforms and services are numbered in the order they first appear
+    platforms = []
+    services = []
+    departures = []
+    for service in route.get("services", []):
+        days = parse_days(service.get("days", "Mon-Sun"))
+        duration = service.get("duration", 0)
+        transfers = service.get("transfers", 0)
+        if not (0 <= duration <= MAX_DURATION and 0 <= transfers <= MAX_TRANSFERS):
+            raise TimetableError("Invalid duration or transfers in %s-%s" % (route["from"], route["to"]))
+        platform = service.get("platform")
+        if platform is None:
+            platform_index = NO_PLATFORM
+        else:
+            if len(platform.encode("ascii")) > PLATFORM_SIZE:
+                raise TimetableError("Platform too long: %r" % platform)
+            if platform not in platforms:
+                platforms.append(platform)
+            platform_index = platforms.index(platform)
+            if platform_index >= MAX_PLATFORMS:
+                raise TimetableError("More than %d platforms in %s-%s" % (MAX_PLATFORMS, route["from"], route["to"]))
+        packed = (days, duration, transfers << 4 | platform_index)
+        if packed not in services:
+            services.append(packed)
+        service_index = services.index(packed)
+        if service_index >= MAX_SERVICES:
+            raise TimetableError("More than %d services in %s-%s" % (MAX_SERVICES, route["from"], route["to"]))
+        for minute in service_departures(service):
+            departures.append((minute, service_index))
+
+    departures.sort()
+    hour_index = []
+    for hour in range(24):
+        hour_index.append(sum(1 for departure in departures if departure[0] < hour * 60))
+    hour_index.append(len(departures))
+
+    block = b"".join(platform.encode("ascii").ljust(PLATFORM_SIZE, b"\0") for platform in platforms)
+    block += b"".join(struct.pack("<BBB", *service) for service in services)
+    block += struct.pack("<%dH" % HOUR_INDEX_COUNT, *hour_index)
+    block += b"".join(struct.pack("<BB", minute % 60, service_index) for minute, service_index in departures)
+    entry = (station_index[route["from"]], station_index[route["to"]], len(departures), len(platforms), len(services))
+    return entry, block
+
+
+def pack(timetable_path, stations_path):
+    with io.open(timetable_path, encoding="utf-8") as f:
+        routes = json.load(f).get("routes", [])
+    if len(routes) > 255:
+        raise TimetableError("More than 255 routes")
+    stations = generate_stations.load_stations(stations_path)
+    station_index = {station["code"]: index for index, station in enumerate(stations)}
+
+    packed = [pack_route(route, station_index) for route in routes]
+    header = b"TT" + struct.pack("<BB", VERSION, len(packed))
+    offset = len(header) + 12 * len(packed)
+    entries = b""
+    blocks = b""
+    for (from_index, to_index, count, platform_count, service_count), block in packed:
+        entries += struct.pack("<HHIHBB", from_index, to_index, offset + len(blocks), count, platform_count, service_count)
+        blocks += block
+    return header + entries + blocks
+
+
+def is_current(timetable_path, stations_path, binary_path):
+    try:
+        with open(binary_path, "rb") as f:
+            return f.read() == pack(timetable_path, stations_path)
+    except IOError:
+        return False
+
+
+def main(argv):
+    timetable_path, stations_path, binary_path = (argv[1:] + list(DEFAULT_PATHS)[len(argv) - 1:])[:3]
+    try:
+        data = pack(timetable_path, stations_path)
+    except (TimetableError, generate_stations.StationDataError) as e:
+        sys.stderr.write("Error: {}\n".format(e))
+        return 1
+    with open(binary_path, "wb") as f:
+        f.write(data)
+    print("Wrote {} ({} bytes)".format(binary_path, len(data)))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
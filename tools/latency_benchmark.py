@@ -0,0 +1,127 @@
+#
+# This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+# Copyright (c) 2025 Guus Beckett.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, version 3.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+"""
+End-to-end latency benchmark in the emulator. Each run launches the app with
+`pebble install --logs`, picks the first nearby station and the first
+destination with emulated button presses, and collects the TRACE markers the
+watch logs in a TREIN_DEBUG build (see src/c/trace.h). When the last route
+opens from the cache on launch no buttons are pressed; the run then measures
+the refresh instead.
+
+Build with `TREIN_DEBUG=1 pebble build` and point the app at
+tools/mock_ns_server.py (settings page, "API URL") for repeatable numbers.
+
+Usage: latency_benchmark.py [--runs 20] [--emulator basalt] [--timeout 30]
+"""
+import argparse
+import math
+import re
+import subprocess
+import sys
+import threading
+import time
+
+TRACE_PATTERN = re.compile(r'TRACE (\w+) (\d+\.\d{3})')
+
+# Intervals reported, as (label, from marker, to marker)
+INTERVALS = [
+    ("start -> stations requested", "app_start", "stations_requested"),
+    ("stations requested -> station menu", "stations_requested", "station_menu"),
+    ("trip requested -> trips received", "trip_requested", "trips_received"),
+    ("trip requested -> countdown", "trip_requested", "countdown"),
+    ("start -> trips received (end to end)", "app_start", "trips_received"),
+]
+
+
+def percentile(values, fraction):
+    """Nearest-rank percentile of a non-empty list."""
+    ordered = sorted(values)
+    rank = max(1, int(math.ceil(fraction * len(ordered))))
+    return ordered[rank - 1]
+
+
+def press(emulator, button):
+    subprocess.run(["pebble", "emu-button", "click", button, "--emulator", emulator],
+                   check=True, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+
+
+def run_once(emulator, timeout):
+    """Launches the app once and returns the first time seen for every marker."""
+    marks = {}
+    done = threading.Event()
+    process = subprocess.Popen(["pebble", "install", "--emulator", emulator, "--logs"],
+                               stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                               universal_newlines=True)
+
+    def read_logs():
+        for line in process.stdout:
+            match = TRACE_PATTERN.search(line)
+            if not match:
+                continue
+            step = match.group(1)
+            marks.setdefault(step, float(match.group(2)))
+            if step == "station_menu" and "countdown" not in marks:
+                # First nearby station, then the first destination
+                press(emulator, "select")
+                time.sleep(0.5)
+                press(emulator, "select")
+            if step == "trips_received":
+                done.set()
+
+    reader = threading.Thread(target=read_logs, daemon=True)
+    reader.start()
+    done.wait(timeout)
+    process.terminate()
+    process.wait()
+    return marks
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description="Measure app latency in the emulator.")
+    parser.add_argument("--runs", type=int, default=20)
+    parser.add_argument("--emulator", default="basalt")
+    parser.add_argument("--timeout", type=float, default=30, help="seconds to wait for trips per run")
+    options = parser.parse_args(argv[1:])
+
+    samples = {label: [] for label, _, _ in INTERVALS}
+    failed = 0
+    for run in range(options.runs):
+        marks = run_once(options.emulator, options.timeout)
+        if "trips_received" not in marks:
+            failed += 1
+            print("Run {}: no trips within {} s".format(run + 1, options.timeout))
+            continue
+        for label, start, end in INTERVALS:
+            if start in marks and end in marks:
+                samples[label].append((marks[end] - marks[start]) * 1000)
+        print("Run {}: {:.0f} ms end to end".format(run + 1, (marks["trips_received"] - marks["app_start"]) * 1000))
+
+    print()
+    print("{:<40} {:>6} {:>8} {:>8}".format("interval", "runs", "p50 ms", "p95 ms"))
+    for label, _, _ in INTERVALS:
+        values = samples[label]
+        if values:
+            print("{:<40} {:>6} {:>8.0f} {:>8.0f}".format(label, len(values), percentile(values, 0.5), percentile(values, 0.95)))
+        else:
+            print("{:<40} {:>6} {:>8} {:>8}".format(label, 0, "-", "-"))
+    if failed:
+        print("{} of {} runs failed".format(failed, options.runs))
+    return 1 if failed == options.runs else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -0,0 +1,180 @@
+#
+# This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+# Copyright (c) 2025 Guus Beckett.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, version 3.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+"""
+Local stand-in for the two NS API endpoints the phone uses, for reproducing
+latency problems in the emulator without a live API key or network.
+
+  serve   Replay recorded responses from a fixtures directory:
+            /nsapp-stations/v2/nearest     <- nearest.json
+            /reisinformatie-api/api/v3/trips <- trips.json
+          Trip times are shifted so the first trip departs --first-departure
+          minutes from now, keeping the spacing of the recording.
+  record  Fetch fresh responses from the live API into the fixtures
+          directory (needs an API key).
+
+Point the app at the server by entering its URL (e.g. http://localhost:8080)
+under "API URL" on the settings page.
+
+Usage: mock_ns_server.py serve [--port 8080] [--latency MS] [--jitter MS]
+                               [--error-rate P] [--error-status CODE]
+                               [--pad BYTES] [--first-departure MIN]
+       mock_ns_server.py record --key KEY [--lat LAT --lng LNG]
+                                [--from CODE --to CODE]
+"""
+import argparse
+import datetime
+import json
+import os
+import random
+import re
+import sys
+import time
+import urllib.parse
+import urllib.request
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+NS_API_URL = "https://gateway.apiportal.ns.nl"
+NEAREST_PATH = "/nsapp-stations/v2/nearest"
+TRIPS_PATH = "/reisinformatie-api/api/v3/trips"
+FIXTURES = {NEAREST_PATH: "nearest.json", TRIPS_PATH: "trips.json"}
+DEFAULT_FIXTURES_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "fixtures")
+
+# NS times look like 2025-10-25T10:14:00+0200
+NS_TIME_FORMAT = "%Y-%m-%dT%H:%M:%S%z"
+NS_TIME_PATTERN = re.compile(r'^\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2}[+-]\d{4}$')
+
+
+def load_fixture(directory, path):
+    with open(os.path.join(directory, FIXTURES[path]), encoding="utf-8") as f:
+        return json.load(f)
+
+
+def first_departure(trips):
+    for trip in trips.get("trips", []):
+        for leg in trip.get("legs", []):
+            planned = leg.get("origin", {}).get("plannedDateTime")
+            if planned:
+                return datetime.datetime.strptime(planned, NS_TIME_FORMAT)
+    return None
+
+
+def shift_times(value, delta):
+    """Returns a copy of a decoded JSON value with every NS time moved by delta."""
+    if isinstance(value, dict):
+        return {key: shift_times(item, delta) for key, item in value.items()}
+    if isinstance(value, list):
+        return [shift_times(item, delta) for item in value]
+    if isinstance(value, str) and NS_TIME_PATTERN.match(value):
+        moved = datetime.datetime.strptime(value, NS_TIME_FORMAT) + delta
+        return moved.strftime(NS_TIME_FORMAT)
+    return value
+
+
+def make_handler(options):
+    fixtures = {path: load_fixture(options.fixtures, path) for path in FIXTURES}
+
+    class Handler(BaseHTTPRequestHandler):
+        def do_GET(self):
+            path = urllib.parse.urlparse(self.path).path
+            delay = options.latency + random.uniform(0, options.jitter)
+            time.sleep(delay / 1000.0)
+
+            if path not in fixtures:
+                self.reply(404, {"message": "No fixture for " + path})
+                return
+            if random.random() < options.error_rate:
+                self.reply(options.error_status, {"message": "Injected error"})
+                return
+
+            body = fixtures[path]
+            if path == TRIPS_PATH:
+                recorded = first_departure(body)
+                if recorded:
+                    now = datetime.datetime.now(recorded.tzinfo)
+                    target = now + datetime.timedelta(minutes=options.first_departure)
+                    body = shift_times(body, target.replace(second=0, microsecond=0) - recorded)
+            if options.pad > 0:
+                body = dict(body, padding="x" * options.pad)
+            self.reply(200, body)
+
+        def reply(self, status, body):
+            data = json.dumps(body).encode("utf-8")
+            self.send_response(status)
+            self.send_header("Content-Type", "application/json")
+            self.send_header("Content-Length", str(len(data)))
+            self.end_headers()
+            self.wfile.write(data)
+
+    return Handler
+
+
+def serve(options):
+    server = ThreadingHTTPServer(("", options.port), make_handler(options))
+    print("Serving {} on port {}".format(options.fixtures, options.port))
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+
+def record(options):
+    queries = {
+        NEAREST_PATH: {"lat": options.lat, "lng": options.lng, "limit": 8,
+                       "includeNonPlannableStations": "false"},
+        TRIPS_PATH: {"fromStation": options.from_station, "toStation": options.to_station},
+    }
+    for path, query in queries.items():
+        request = urllib.request.Request(NS_API_URL + path + "?" + urllib.parse.urlencode(query),
+                                         headers={"Ocp-Apim-Subscription-Key": options.key})
+        with urllib.request.urlopen(request) as response:
+            body = json.load(response)
+        target = os.path.join(options.fixtures, FIXTURES[path])
+        with open(target, "w", encoding="utf-8") as f:
+            json.dump(body, f, indent=2, ensure_ascii=False)
+        print("Recorded " + target)
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description="Local stand-in for the NS API.")
+    parser.add_argument("--fixtures", default=DEFAULT_FIXTURES_DIR, help="directory with recorded responses")
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    serve_parser = commands.add_parser("serve", help="replay recorded responses")
+    serve_parser.add_argument("--port", type=int, default=8080)
+    serve_parser.add_argument("--latency", type=float, default=0, help="fixed delay per response, in ms")
+    serve_parser.add_argument("--jitter", type=float, default=0, help="random extra delay up to this many ms")
+    serve_parser.add_argument("--error-rate", type=float, default=0, help="fraction of requests that fail")
+    serve_parser.add_argument("--error-status", type=int, default=503, help="HTTP status of a failed request")
+    serve_parser.add_argument("--pad", type=int, default=0, help="bytes of padding added to every response")
+    serve_parser.add_argument("--first-departure", type=float, default=4,
+                              help="minutes from now until the first trip departs")
+    serve_parser.set_defaults(run=serve)
+
+    record_parser = commands.add_parser("record", help="record responses from the live API")
+    record_parser.add_argument("--key", required=True, help="NS API subscription key")
+    record_parser.add_argument("--lat", type=float, default=51.58719)
+    record_parser.add_argument("--lng", type=float, default=4.78322)
+    record_parser.add_argument("--from", dest="from_station", default="BD")
+    record_parser.add_argument("--to", dest="to_station", default="UT")
+    record_parser.set_defaults(run=record)
+
+    options = parser.parse_args(argv[1:])
+    options.run(options)
+
+
+if __name__ == '__main__':
+    main(sys.argv)
@@ -0,0 +1,123 @@
+/*
+ * This file is part of the Trein Pebble app distribution (https://github.com/guusbeckett/trein-pebble).
+ * Copyright (c) 2025 Guus Beckett.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <pebble_worker.h>
+#include "../../src/c/tracked_trip.h"
+
+// Background worker that keeps counting down to the tracked trip after the
+// app has closed, see src/c/tracked_trip.h. It only wakes on minute ticks
+// and launches the app whenever there is something to show, because workers
+// cannot vibrate themselves. After the last alert the app stops the worker.
+
+static TrackedTrip s_trip;
+static bool s_tracking;
+
+static int prv_lead_minutes(void) {
+  return persist_exists(PERSIST_KEY_REMINDER_LEAD) ? persist_read_int(PERSIST_KEY_REMINDER_LEAD) : DEFAULT_REMINDER_LEAD_MINUTES;
+}
+
+static void prv_save(void) {
+  persist_write_data(PERSIST_KEY_TRACKED_TRIP, &s_trip, sizeof(s_trip));
+}
+
+// The app shows the alert, vibrating and with the latest platform and delay.
+// If it is already open the message reaches it, otherwise it is launched.
+static void prv_alert(void) {
+  prv_save();
+  AppWorkerMessage message = { 0 };
+  app_worker_send_message(TRACKING_MSG_ALERT, &message);
+  worker_launch_app();
+}
+
+static void prv_stop(void) {
+  s_tracking = false;
+  tick_timer_service_unsubscribe();
+}
+
+// Alert once per lead time. A delay that moves the departure back past a
+// lead time arms its alert again. The final alert and a cancellation end
+// tracking; a departure whose final alert was missed, e.g. while the watch
+// was off, counts as its final alert.
+static void prv_check(time_t now) {
+  if (!s_tracking) { return; }
+  const uint8_t due = tracking_alerts_due(&s_trip, now, prv_lead_minutes());
+  const bool done = (due & TRACKING_ALERT_FINAL) || (s_trip.flags & TRACKED_TRIP_CANCELLED);
+  const uint8_t previous = s_trip.alerts_sent;
+  s_trip.alerts_sent &= due;
+  if (done || (due & ~s_trip.alerts_sent)) {
+    s_trip.alerts_sent |= due;
+    if (done) {
+      s_trip.alerts_sent |= TRACKING_DONE;
+      prv_stop();
+    }
+    prv_alert();
+  } else if (s_trip.alerts_sent != previous) {
+    prv_save();
+  }
+}
+
+static void prv_tick_handler(struct tm *tick_time, TimeUnits units_changed) {
+  prv_check(time(NULL));
+}
+
+static void prv_track(void) {
+  s_tracking = persist_read_data(PERSIST_KEY_TRACKED_TRIP, &s_trip, sizeof(s_trip)) == (int)sizeof(s_trip) &&
+               !(s_trip.alerts_sent & TRACKING_DONE);
+  if (!s_tracking) {
+    prv_stop();
+    return;
+  }
+  tick_timer_service_subscribe(MINUTE_UNIT, prv_tick_handler);
+  prv_check(time(NULL));
+}
+
+// Updates come from the open app, which shows the change itself. Only a
+// departure moved into a lead time or a cancellation still alerts.
+static void prv_update(const AppWorkerMessage *message) {
+  if (!s_tracking) { return; }
+  TrackedTrip update = s_trip;
+  tracking_unpack_update(message, &update);
+  if (update.delay == s_trip.delay && update.flags == s_trip.flags &&
+      strncmp(update.platform, s_trip.platform, sizeof(update.platform)) == 0) { return; }
+
+  s_trip = update;
+  prv_save();
+  prv_check(time(NULL));
+}
+
+static void prv_message_handler(uint16_t type, AppWorkerMessage *message) {
+  switch (type) {
+    case TRACKING_MSG_TRACK: prv_track(); break;
+    case TRACKING_MSG_UPDATE: prv_update(message); break;
+    default: break;
+  }
+}
+
+static void prv_init(void) {
+  app_worker_message_subscribe(prv_message_handler);
+  prv_track();
+}
+
+static void prv_deinit(void) {
+  app_worker_message_unsubscribe();
+  tick_timer_service_unsubscribe();
+}
+
+int main(void) {
+  prv_init();
+  worker_event_loop();
+  prv_deinit();
+}